@@ -0,0 +1,45 @@
+#include "BufferedWriter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+BufferedWriter::BufferedWriter(std::ostream& out) :
+    out(out),
+    n(0) {
+  //
+}
+
+BufferedWriter::~BufferedWriter() {
+  if (n > 0) {
+    out.write(buffer, n);
+  }
+  out.flush();
+}
+
+void BufferedWriter::write(const std::string_view& str) {
+  std::size_t i = 0;
+  while (i < str.size()) {
+    if (n == sizeof(buffer)) {
+      flush();
+    }
+    std::size_t m = std::min(str.size() - i, sizeof(buffer) - n);
+    std::copy_n(str.data() + i, m, buffer + n);
+    n += m;
+    i += m;
+  }
+}
+
+void BufferedWriter::write(const long long value) {
+  char digits[24];
+  auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+  write(std::string_view(digits, end - digits));
+}
+
+void BufferedWriter::flush() {
+  out.write(buffer, n);
+  n = 0;
+  if (!out) {
+    throw std::runtime_error("could not write output");
+  }
+}
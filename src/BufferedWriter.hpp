@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+
+/**
+ * Buffered writer to an output stream, with a fixed-size buffer.
+ *
+ * @ingroup developer
+ *
+ * Output is accumulated in the buffer and written to the stream in blocks
+ * whenever it fills, so that memory use is bounded regardless of the amount
+ * of output, and the stream sees few, large writes.
+ */
+class BufferedWriter {
+public:
+  /**
+   * Constructor.
+   *
+   * @param out Output stream.
+   */
+  BufferedWriter(std::ostream& out);
+
+  /**
+   * Destructor. Flushes any remaining output.
+   */
+  ~BufferedWriter();
+
+  BufferedWriter(const BufferedWriter&) = delete;
+  BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+  /**
+   * Write a character.
+   */
+  void put(const char c) {
+    if (n == sizeof(buffer)) {
+      flush();
+    }
+    buffer[n++] = c;
+  }
+
+  /**
+   * Write a string.
+   */
+  void write(const std::string_view& str);
+
+  /**
+   * Write an integer.
+   */
+  void write(const long long value);
+
+  /**
+   * Write the buffer to the stream.
+   */
+  void flush();
+
+private:
+  /**
+   * Output stream.
+   */
+  std::ostream& out;
+
+  /**
+   * Number of characters in the buffer.
+   */
+  std::size_t n;
+
+  /**
+   * Buffer.
+   */
+  char buffer[65536];
+};
@@ -0,0 +1,247 @@
+#include "ContributorMap.hpp"
+
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+/**
+ * Name of the contributor map file in the output directory.
+ *
+ * @ingroup developer
+ */
+static const char* CONTRIBUTORS_NAME = ".doxide.contributors";
+
+/**
+ * First line of the contributor map file.
+ *
+ * @ingroup developer
+ */
+static const char* CONTRIBUTORS_HEADER = "# doxide contributors 2";
+
+ContributorMap::ContributorMap(const std::filesystem::path& output) :
+    output(output) {
+  //
+}
+
+bool ContributorMap::load() {
+  files.clear();
+  indices.clear();
+  subtrees.clear();
+  targets.clear();
+  dirty.clear();
+  std::filesystem::path path = output / CONTRIBUTORS_NAME;
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(in, line) || line != CONTRIBUTORS_HEADER) {
+    throw std::runtime_error("unrecognized contributor map " + path.string());
+  }
+  auto malformed = [&]() {
+    return std::runtime_error("malformed contributor map " + path.string());
+  };
+  while (std::getline(in, line)) {
+    if (line.size() < 3 || line[1] != '\t') {
+      throw malformed();
+    }
+    std::string_view rest = std::string_view(line).substr(2);
+    if (line[0] == 'F') {
+      source(std::string(rest));
+    } else if (line[0] == 'D') {
+      dirty.insert(std::string(rest));
+    } else if (line[0] == 'S') {
+      std::size_t tab1 = rest.find('\t');
+      std::size_t tab2 = rest.find('\t', tab1 + 1);
+      if (tab1 == std::string_view::npos || tab2 == std::string_view::npos) {
+        throw malformed();
+      }
+      Subtree s{std::string(rest.substr(0, tab1)),
+          std::string(rest.substr(tab1 + 1, tab2 - tab1 - 1)), {}};
+      const char* first = rest.data() + tab2 + 1;
+      const char* last = rest.data() + rest.size();
+      while (first < last) {
+        std::size_t i = 0;
+        auto [ptr, ec] = std::from_chars(first, last, i);
+        if (ec != std::errc() || i >= files.size() ||
+            (ptr != last && *ptr != ' ')) {
+          throw malformed();
+        }
+        s.sources.push_back(i);
+        first = (ptr == last) ? last : ptr + 1;
+      }
+      subtrees.push_back(std::move(s));
+    } else if (line[0] == 'L') {
+      std::size_t tab1 = rest.find('\t');
+      std::size_t tab2 = rest.find('\t', tab1 + 1);
+      std::size_t tab3 = rest.find('\t', tab2 + 1);
+      if (tab1 == std::string_view::npos || tab2 == std::string_view::npos ||
+          tab3 == std::string_view::npos) {
+        throw malformed();
+      }
+      int type = 0;
+      auto [ptr, ec] = std::from_chars(rest.data() + tab1 + 1,
+          rest.data() + tab2, type);
+      if (ec != std::errc() || ptr != rest.data() + tab2) {
+        throw malformed();
+      }
+      targets.push_back(Link{std::string(rest.substr(0, tab1)), type,
+          std::string(rest.substr(tab2 + 1, tab3 - tab2 - 1)),
+          std::string(rest.substr(tab3 + 1))});
+    } else {
+      throw malformed();
+    }
+  }
+  return true;
+}
+
+void ContributorMap::save() const {
+  std::filesystem::path path = output / CONTRIBUTORS_NAME;
+  if (files.empty() && subtrees.empty() && targets.empty() &&
+      dirty.empty()) {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return;
+  }
+
+  /* write to a temporary file then rename, as for the manifest */
+  std::filesystem::path tmp = path;
+  tmp += ".tmp";
+  std::ofstream out(tmp, std::ios::binary);
+  out << CONTRIBUTORS_HEADER << '\n';
+  for (auto& file : files) {
+    out << "F\t" << file << '\n';
+  }
+  for (auto& s : subtrees) {
+    out << "S\t" << s.page << '\t' << s.name << '\t';
+    for (std::size_t k = 0; k < s.sources.size(); ++k) {
+      out << (k > 0 ? " " : "") << s.sources[k];
+    }
+    out << '\n';
+  }
+  for (auto& l : targets) {
+    out << "L\t" << l.name << '\t' << l.type << '\t' << l.page << '\t' <<
+        l.anchor << '\n';
+  }
+  for (auto& page : dirty) {
+    out << "D\t" << page << '\n';
+  }
+  out.close();
+  if (!out) {
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+    throw std::runtime_error("could not write " + path.string());
+  }
+  std::filesystem::rename(tmp, path);
+}
+
+void ContributorMap::clear() {
+  files.clear();
+  indices.clear();
+  subtrees.clear();
+  targets.clear();
+}
+
+std::size_t ContributorMap::source(const std::string& file) {
+  auto [iter, inserted] = indices.try_emplace(file, files.size());
+  if (inserted) {
+    files.push_back(file);
+  }
+  return iter->second;
+}
+
+void ContributorMap::subtree(const std::filesystem::path& page,
+    const std::string& name, std::vector<std::size_t>&& sources) {
+  subtrees.push_back(Subtree{stem(page), name, std::move(sources)});
+}
+
+void ContributorMap::link(const std::string& name, const int type,
+    const std::filesystem::path& page, const std::string& anchor) {
+  targets.push_back(Link{name, type, key(page), anchor});
+}
+
+bool ContributorMap::find(const std::string_view& target,
+    std::set<std::string>& files) const {
+  /* a target may match more than one subtree, e.g. a namespace and a group
+   * of the same name, in which case all are included */
+  bool found = false;
+  std::string target_stem = stem(target);
+  for (auto& s : subtrees) {
+    if (s.name == target || s.page == target_stem) {
+      for (auto i : s.sources) {
+        files.insert(this->files[i]);
+      }
+      found = true;
+    }
+  }
+  return found;
+}
+
+bool ContributorMap::known(const std::string& file) const {
+  return indices.contains(file);
+}
+
+bool ContributorMap::matches(const std::filesystem::path& page,
+    const std::string_view& name, const std::string_view& target) const {
+  return name == target || stem(page) == stem(target);
+}
+
+void ContributorMap::mark(const std::filesystem::path& file) {
+  dirty.insert(key(file));
+}
+
+void ContributorMap::unmark(const std::filesystem::path& file) {
+  dirty.erase(key(file));
+}
+
+void ContributorMap::unmark() {
+  dirty.clear();
+}
+
+std::vector<std::filesystem::path> ContributorMap::marked() const {
+  std::vector<std::filesystem::path> result;
+  for (auto& page : dirty) {
+    result.push_back(output / std::filesystem::path(page));
+  }
+  return result;
+}
+
+std::string ContributorMap::key(const std::filesystem::path& file) const {
+  /* files are usually formed as the output directory followed by a clean
+   * relative path, for which stripping the prefix gives the same result as,
+   * but is much faster than, lexically_relative(), which matters with a
+   * target of cross-references for every entity */
+  std::string str = file.generic_string();
+  std::string prefix = output.generic_string();
+  if (!prefix.empty()) {
+    if (prefix.back() != '/') {
+      prefix.push_back('/');
+    }
+    if (str.starts_with(prefix) && !str.ends_with('.') &&
+        str.find("./", prefix.size()) == std::string::npos) {
+      return str.substr(prefix.size());
+    }
+  }
+  return file.lexically_relative(output).generic_string();
+}
+
+std::string ContributorMap::stem(const std::filesystem::path& page) const {
+  /* accept paths that include the output directory, as well as those
+   * relative to it */
+  std::filesystem::path p = page.lexically_normal();
+  std::filesystem::path rel = p.lexically_relative(output.lexically_normal());
+  if (!rel.empty() && *rel.begin() != "..") {
+    p = rel;
+  }
+  if (!p.empty() && !p.has_filename()) {
+    p = p.parent_path();  // trailing slash
+  }
+  if (p.extension() == ".md" || p.extension() == ".html") {
+    p.replace_extension();
+  }
+  if (p.filename() == "index") {
+    p = p.parent_path();
+  }
+  return p.generic_string();
+}
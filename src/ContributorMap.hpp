@@ -0,0 +1,267 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Map of the source files that contribute to each subtree of the output.
+ *
+ * @ingroup developer
+ *
+ * The map is kept in the output directory, next to the manifest (see
+ * Manifest), in a file named `.doxide.contributors`. It is written by each
+ * full build, and records, for each namespace, group and type with a page of
+ * its own, the source files that declare any entity documented on that page
+ * or the pages beneath it. A partial build of a single subtree (see `build
+ * --only`) uses it to parse only those files.
+ *
+ * It also records the targets of cross-references, being the page and anchor
+ * at which each entity is documented, by qualified name, so that a partial
+ * build can still link to entities outside of the subtree that it parses.
+ *
+ * Finally, it records the pages written by partial builds since the last full
+ * build. The contents of those pages no longer match the hashes in the
+ * manifest, which is left untouched by partial builds, so the next build
+ * compares their contents instead.
+ *
+ * The file is plain text, with one entry per line: `F` and the path of a
+ * source file; `S`, the page of a subtree, its name and the indices of its
+ * source files, in the order of the `F` lines; `L`, the qualified name of a
+ * target of cross-references, the value of its EntityType, its page, and its
+ * anchor, if any; or `D` and the path of a page written by a partial build.
+ * Fields are separated by tabs.
+ */
+class ContributorMap {
+public:
+  /**
+   * Target of cross-references.
+   */
+  struct Link {
+    /**
+     * Qualified name.
+     */
+    std::string name;
+
+    /**
+     * Type of the entity, as the value of its EntityType.
+     */
+    int type;
+
+    /**
+     * Page, relative to the output directory.
+     */
+    std::string page;
+
+    /**
+     * Anchor on the page, or empty for the top of the page.
+     */
+    std::string anchor;
+  };
+
+  /**
+   * Constructor.
+   *
+   * @param output Output directory.
+   */
+  ContributorMap(const std::filesystem::path& output);
+
+  /**
+   * Load the map from the output directory. If it does not exist, the map is
+   * left empty.
+   *
+   * @return True if the map exists and was loaded, false otherwise.
+   */
+  bool load();
+
+  /**
+   * Save the map to the output directory. If the map is empty, any existing
+   * map file is removed instead.
+   */
+  void save() const;
+
+  /**
+   * Clear the source files, subtrees and targets of cross-references. Pages
+   * marked as written by a partial build are kept.
+   */
+  void clear();
+
+  /**
+   * Add a source file, if not already added.
+   *
+   * @param file Source file path, as given in the configuration.
+   *
+   * @return Index of the source file.
+   */
+  std::size_t source(const std::string& file);
+
+  /**
+   * Add a subtree.
+   *
+   * @param page File name of the page of the subtree, including the output
+   * directory.
+   * @param name Name of the subtree: the qualified name of a namespace or
+   * type, or the name of a group.
+   * @param sources Indices of the source files that contribute to the
+   * subtree, as returned by source().
+   */
+  void subtree(const std::filesystem::path& page, const std::string& name,
+      std::vector<std::size_t>&& sources);
+
+  /**
+   * Add a target of cross-references.
+   *
+   * @param name Qualified name.
+   * @param type Type of the entity, as the value of its EntityType.
+   * @param page Page on which the entity is documented, including the output
+   * directory.
+   * @param anchor Anchor on the page, or empty for the top of the page.
+   */
+  void link(const std::string& name, const int type,
+      const std::filesystem::path& page, const std::string& anchor);
+
+  /**
+   * Targets of cross-references, in the order added.
+   */
+  const std::vector<Link>& links() const {
+    return targets;
+  }
+
+  /**
+   * Find the source files that contribute to a subtree.
+   *
+   * @param target Subtree, by name or page (see matches()).
+   * @param[out] files Source files that contribute to any matching subtree.
+   *
+   * @return True if any subtree matches, false otherwise.
+   */
+  bool find(const std::string_view& target, std::set<std::string>& files)
+      const;
+
+  /**
+   * Was a source file part of the build that wrote the map?
+   *
+   * @param file Source file path, as given in the configuration.
+   */
+  bool known(const std::string& file) const;
+
+  /**
+   * Does a subtree match a target?
+   *
+   * @param page File name of the page of the subtree, including the output
+   * directory.
+   * @param name Name of the subtree.
+   * @param target Target: the qualified name of a namespace or type, e.g.
+   * `ns::Type`, the name of a group, or the path of the page, e.g.
+   * `ns/Type.md` or `ns`, relative to the output directory or including it,
+   * with or without its extension.
+   */
+  bool matches(const std::filesystem::path& page, const std::string_view& name,
+      const std::string_view& target) const;
+
+  /**
+   * Mark a page as written by a partial build.
+   *
+   * @param file File path, including the output directory.
+   */
+  void mark(const std::filesystem::path& file);
+
+  /**
+   * Unmark a page as written by a partial build.
+   *
+   * @param file File path, including the output directory.
+   */
+  void unmark(const std::filesystem::path& file);
+
+  /**
+   * Unmark all pages.
+   */
+  void unmark();
+
+  /**
+   * Is a page marked as written by a partial build?
+   *
+   * @param file File path, including the output directory.
+   */
+  bool marked(const std::filesystem::path& file) const {
+    return !dirty.empty() && dirty.contains(key(file));
+  }
+
+  /**
+   * Pages marked as written by a partial build, as paths including the
+   * output directory.
+   */
+  std::vector<std::filesystem::path> marked() const;
+
+private:
+  /**
+   * Subtree.
+   */
+  struct Subtree {
+    /**
+     * Page, relative to the output directory, without extension, and without
+     * a final `index`.
+     */
+    std::string page;
+
+    /**
+     * Name.
+     */
+    std::string name;
+
+    /**
+     * Indices of source files.
+     */
+    std::vector<std::size_t> sources;
+  };
+
+  /**
+   * Key for a file, which is its path relative to the output directory.
+   */
+  std::string key(const std::filesystem::path& file) const;
+
+  /**
+   * Page of a subtree or target, relative to the output directory, without
+   * extension, and without a final `index`, so that all the ways of naming
+   * the same page compare equal.
+   *
+   * @param page Page, relative to the output directory or including it.
+   */
+  std::string stem(const std::filesystem::path& page) const;
+
+  /**
+   * Output directory.
+   */
+  std::filesystem::path output;
+
+  /**
+   * Source files, by index.
+   */
+  std::vector<std::string> files;
+
+  /**
+   * Indices of source files, by path.
+   */
+  std::unordered_map<std::string,std::size_t> indices;
+
+  /**
+   * Subtrees.
+   */
+  std::vector<Subtree> subtrees;
+
+  /**
+   * Targets of cross-references.
+   */
+  std::vector<Link> targets;
+
+  /**
+   * Pages written by partial builds, by path relative to the output
+   * directory. Ordered, so that the map file is identical for identical
+   * output.
+   */
+  std::set<std::string> dirty;
+};
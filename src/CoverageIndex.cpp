@@ -0,0 +1,99 @@
+#include "CoverageIndex.hpp"
+
+#include <algorithm>
+#include <bit>
+
+void CoverageIndex::build(const Entity& root) {
+  files.clear();
+  scopes.clear();
+  add(root);
+  memoize(root);
+}
+
+CoverageIndex::Counts CoverageIndex::get(const Entity& entity) const {
+  Counts counts;
+  if (entity.type == EntityType::FILE || entity.type == EntityType::DIR) {
+    /* already aggregated by the counter */
+    counts.included = entity.lines_included;
+    counts.covered = entity.lines_covered;
+  } else if (entity.type == EntityType::ROOT ||
+      entity.type == EntityType::NAMESPACE ||
+      entity.type == EntityType::GROUP) {
+    /* may span multiple files, memoized by build() */
+    auto iter = scopes.find(&entity);
+    if (iter != scopes.end()) {
+      counts = iter->second;
+    }
+  } else {
+    /* range query over lines of the declaration */
+    auto iter = files.find(entity.path);
+    if (iter != files.end()) {
+      auto& sums = iter->second;
+      auto& lines = *sums.lines;
+      uint32_t first = std::min(entity.start_line, lines.size());
+      uint32_t last = std::min(entity.end_line + 1, lines.size());
+      if (first < last) {
+        counts.included = rank(lines.included_bits(), sums.included, last) -
+            rank(lines.included_bits(), sums.included, first);
+        counts.covered = rank(lines.covered_bits(), sums.covered, last) -
+            rank(lines.covered_bits(), sums.covered, first);
+      }
+    }
+  }
+  return counts;
+}
+
+CoverageIndex::Counts CoverageIndex::memoize(const Entity& entity) {
+  /* sum over children, for those that may span multiple files, but visit
+   * all, as namespaces and groups may be nested anywhere */
+  Counts counts;
+  for (auto list : Entity::lists) {
+    if (list != &Entity::dirs && list != &Entity::files) {
+      for (auto& child : entity.*list) {
+        Counts c = memoize(child);
+        counts.included += c.included;
+        counts.covered += c.covered;
+      }
+    }
+  }
+  if (entity.type == EntityType::ROOT ||
+      entity.type == EntityType::NAMESPACE ||
+      entity.type == EntityType::GROUP) {
+    scopes.emplace(&entity, counts);
+    return counts;
+  } else {
+    return get(entity);
+  }
+}
+
+void CoverageIndex::add(const Entity& entity) {
+  for (auto& dir : entity.dirs) {
+    add(dir);
+  }
+  for (auto& file : entity.files) {
+    auto& sums = files[file.path];
+    auto& lines = file.line_counts;
+    auto& included = lines.included_bits();
+    auto& covered = lines.covered_bits();
+    sums.lines = &lines;
+    sums.included.resize(included.size() + 1);
+    sums.covered.resize(covered.size() + 1);
+    sums.included[0] = 0;
+    sums.covered[0] = 0;
+    for (std::size_t i = 0; i < included.size(); ++i) {
+      sums.included[i + 1] = sums.included[i] + std::popcount(included[i]);
+      sums.covered[i + 1] = sums.covered[i] + std::popcount(covered[i]);
+    }
+  }
+}
+
+uint32_t CoverageIndex::rank(const std::vector<uint64_t>& bits,
+    const std::vector<uint32_t>& sums, const uint32_t line) {
+  uint32_t word = line/64;
+  uint32_t bit = line % 64;
+  uint32_t r = sums[word];
+  if (bit > 0) {
+    r += std::popcount(bits[word] & ((uint64_t(1) << bit) - 1));
+  }
+  return r;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Entity.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Index of line coverage, for coverage figures of individual entities.
+ *
+ * @ingroup developer
+ *
+ * For each file, holds prefix sums, per 64-line word of the bitmaps of
+ * LineCounts, of the number of lines included in, and covered by, coverage
+ * counts. The coverage of any entity with a source location is then a range
+ * query over the lines of its declaration, in constant time: the prefix sum
+ * to the word containing each end of the range, plus a population count
+ * within that word. The coverage of a namespace or group, which may span many
+ * files, is the sum of that of its children, computed once when the index
+ * is built. Once built, the index is only read, so may be queried
+ * concurrently.
+ */
+class CoverageIndex {
+public:
+  /**
+   * Line counts for an entity.
+   */
+  struct Counts {
+    /**
+     * Number of lines included in coverage counts.
+     */
+    uint32_t included = 0;
+
+    /**
+     * Number of lines covered.
+     */
+    uint32_t covered = 0;
+  };
+
+  /**
+   * Build the index.
+   *
+   * @param root Root entity.
+   */
+  void build(const Entity& root);
+
+  /**
+   * Get the line counts of an entity.
+   *
+   * @param entity Entity.
+   */
+  Counts get(const Entity& entity) const;
+
+private:
+  /**
+   * Prefix sums for a file. Element `i` gives the count over words
+   * `[0, i)` of the bitmaps, so that each has one more element than there
+   * are words.
+   */
+  struct Sums {
+    const LineCounts* lines;
+    std::vector<uint32_t> included;
+    std::vector<uint32_t> covered;
+  };
+
+  /**
+   * Count of set bits in a bitmap over `[0, line)`.
+   */
+  static uint32_t rank(const std::vector<uint64_t>& bits,
+      const std::vector<uint32_t>& sums, const uint32_t line);
+
+  /**
+   * Recursively add files to the index.
+   */
+  void add(const Entity& entity);
+
+  /**
+   * Recursively compute and memoize the counts of namespaces and groups.
+   */
+  Counts memoize(const Entity& entity);
+
+  /**
+   * Prefix sums, by file.
+   */
+  std::unordered_map<FilePath,Sums> files;
+
+  /**
+   * Memoized counts of namespaces and groups.
+   */
+  std::unordered_map<const Entity*,Counts> scopes;
+};
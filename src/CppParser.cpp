@@ -3,6 +3,7 @@
 #include "Doc.hpp"
 #include "DocToken.hpp"
 #include "Entity.hpp"
+#include "Highlight.hpp"
 #include "Log.hpp"
 #include "Regex.hpp"
 #include "TextLineCursor.hpp"
@@ -11,6 +12,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <iterator>
 #include <ostream>
 #include <regex>
 #include <utility>
@@ -449,6 +451,133 @@ static const char* query_cpp_include = R""""(
 ]
 )"""";
 
+/**
+ * Query for syntax highlighting of C++ sources. Capture names are the
+ * classes of the corresponding tokens in Pygments, mapped to styles by
+ * highlight_styles. Where captures overlap, the last wins, so that tokens
+ * nested within others (e.g. escape sequences within strings) take
+ * precedence.
+ *
+ * @ingroup developer
+ */
+static const char* query_cpp_highlight = R""""(
+(comment) @c
+
+[
+  "#define"
+  "#elif"
+  "#else"
+  "#endif"
+  "#if"
+  "#ifdef"
+  "#ifndef"
+  "#include"
+  (preproc_directive)
+] @cp
+
+(system_lib_string) @cpf
+
+[
+  "break"
+  "case"
+  "catch"
+  "class"
+  "co_await"
+  "co_return"
+  "co_yield"
+  "concept"
+  "const"
+  "constexpr"
+  "continue"
+  "decltype"
+  "default"
+  "delete"
+  "do"
+  "else"
+  "enum"
+  "explicit"
+  "extern"
+  "final"
+  "for"
+  "friend"
+  "goto"
+  "if"
+  "inline"
+  "mutable"
+  "namespace"
+  "new"
+  "noexcept"
+  "operator"
+  "override"
+  "private"
+  "protected"
+  "public"
+  "requires"
+  "return"
+  "sizeof"
+  "static"
+  "static_assert"
+  "struct"
+  "switch"
+  "template"
+  "throw"
+  "try"
+  "typedef"
+  "typename"
+  "union"
+  "using"
+  "virtual"
+  "volatile"
+  "while"
+] @k
+
+[
+  (true)
+  (false)
+  (this)
+] @kc
+
+[
+  (primitive_type)
+  (sized_type_specifier)
+] @kt
+
+(string_literal) @s
+(raw_string_literal) @s
+(char_literal) @sc
+(escape_sequence) @se
+(number_literal) @m
+
+(type_identifier) @nc
+(namespace_identifier) @nn
+
+(function_declarator declarator: (identifier) @nf)
+(function_declarator declarator: (field_identifier) @nf)
+(function_declarator
+    declarator: (qualified_identifier name: (identifier) @nf))
+)"""";
+
+/**
+ * Syntax highlighting styles, by capture name in query_cpp_highlight.
+ *
+ * @ingroup developer
+ */
+static const std::pair<const char*,Highlight> highlight_styles[] = {
+  {"c", Highlight::COMMENT},
+  {"cp", Highlight::PREPROC},
+  {"cpf", Highlight::PREPROC_FILE},
+  {"k", Highlight::KEYWORD},
+  {"kc", Highlight::KEYWORD_CONSTANT},
+  {"kt", Highlight::KEYWORD_TYPE},
+  {"s", Highlight::STRING},
+  {"sc", Highlight::STRING_CHAR},
+  {"se", Highlight::STRING_ESCAPE},
+  {"m", Highlight::NUMBER},
+  {"nc", Highlight::NAME_CLASS},
+  {"nf", Highlight::NAME_FUNCTION},
+  {"nn", Highlight::NAME_NAMESPACE}
+};
+
 /**
  * Tree-sitter CUDA language handle.
  *
@@ -456,11 +585,12 @@ static const char* query_cpp_include = R""""(
  */
 extern "C" const TSLanguage* tree_sitter_cuda();
 
-CppParser::CppParser() :
+CppParser::CppParser(const bool highlight) :
     parser(nullptr),
     query(nullptr),
     query_exclude(nullptr),
-    query_include(nullptr) {
+    query_include(nullptr),
+    query_highlight(nullptr) {
   uint32_t error_offset;
   TSQueryError error_type;
 
@@ -492,12 +622,45 @@ CppParser::CppParser() :
         std::min(size_t(40), strlen(query_cpp_include) - error_offset));
     error("invalid query starting '" << from << "'...");
   }
+
+  if (highlight) {
+    /* only a warning, as highlighting is optional, and the node types that
+     * it uses are more likely to vary between versions of the grammar */
+    query_highlight = ts_query_new(tree_sitter_cuda(), query_cpp_highlight,
+        uint32_t(strlen(query_cpp_highlight)), &error_offset, &error_type);
+    if (error_type != TSQueryErrorNone) {
+      std::string_view from(query_cpp_highlight + error_offset,
+          std::min(size_t(40), strlen(query_cpp_highlight) - error_offset));
+      warn("invalid highlight query starting '" << from <<
+          "'..., highlighting disabled");
+      ts_query_delete(query_highlight);
+      query_highlight = nullptr;
+    } else {
+      /* map capture ids to styles once, rather than for each capture */
+      for (uint32_t id = 0; id < ts_query_capture_count(query_highlight);
+          ++id) {
+        uint32_t length = 0;
+        const char* name = ts_query_capture_name_for_id(query_highlight, id,
+            &length);
+        Highlight style = Highlight::NONE;
+        for (auto& [key, value] : highlight_styles) {
+          if (std::string_view(name, length) == key) {
+            style = value;
+          }
+        }
+        capture_styles.push_back(style);
+      }
+    }
+  }
 }
 
 CppParser::~CppParser() {
   ts_query_delete(query);
   ts_query_delete(query_exclude);
   ts_query_delete(query_include);
+  if (query_highlight) {
+    ts_query_delete(query_highlight);
+  }
   ts_parser_delete(parser);
 }
 
@@ -508,11 +671,14 @@ void CppParser::parse(const std::filesystem::path& filename,
   assert(starts.empty());
   assert(ends.empty());
 
+  /* interned path, shared by all entities in the file */
+  FilePath path(filename);
+
   /* entity to represent file */
   Entity file;
   file.name = filename.filename().string();
-  file.decl = preprocess(filename, defines);
-  file.path = filename;
+  file.decl = path.load(preprocess(filename, defines));
+  file.path = path;
   file.start_line = 0;
   file.end_line = 0;
   file.type = EntityType::FILE;
@@ -532,12 +698,18 @@ void CppParser::parse(const std::filesystem::path& filename,
     report(filename, file_content.view(), tree);
   }
 
+  /* syntax highlighting, before querying entities, as the declarations of
+   * templates derive their highlighting from it when combined */
+  if (query_highlight) {
+    path.highlight(highlight(file_content.view(), tree));
+  }
+
   /* query entity information */
   TSNode node = ts_tree_root_node(tree);
 
   file.start_line = 0;
   file.end_line = ts_node_end_point(node).row;
-  file.line_counts.resize(file.end_line, -1);
+  file.line_counts.resize(file.end_line);
 
   /* push root entity to stack */
   push(std::move(root), ts_node_start_byte(node), ts_node_end_byte(node));
@@ -583,7 +755,7 @@ void CppParser::parse(const std::filesystem::path& filename,
          * maintaining the std::string_view and using
          * std::cregex_token_iterator seems to have memory issues when mixed
          * with other local variables */
-        std::string name = file.decl.substr(k, l - k);
+        std::string name(file.decl.substr(k, l - k));
         std::sregex_token_iterator ns_iter(name.begin(), name.end(), sep, -1);
         std::sregex_token_iterator ns_end;
         assert(ns_iter != ns_end);
@@ -593,7 +765,7 @@ void CppParser::parse(const std::filesystem::path& filename,
           Entity parent;
           parent.type = EntityType::NAMESPACE;
           parent.name = prev;
-          parent.path = filename;
+          parent.path = path;
 
           push(std::move(parent), start, end);
           prev = *ns_iter;
@@ -650,7 +822,7 @@ void CppParser::parse(const std::filesystem::path& filename,
       }
 
       entity.decl = file.decl.substr(start, middle - start);
-      entity.path = filename; // set in case of error, to report the file
+      entity.path = path; // set in case of error, to report the file
       entity.start_line = start_line;
       entity.end_line = end_line;
       entity.visible = !entity.docs.empty();
@@ -711,7 +883,7 @@ void CppParser::parse(const std::filesystem::path& filename,
       } else if (strncmp(name, "if_constexpr", length) == 0) {
         /* check if this is `constexpr`, which is not reflected in the
          * parse tree and requires a string comparison */
-        std::string stmt = file.decl.substr(start, end - start);
+        std::string stmt(file.decl.substr(start, end - start));
         constexpr_context = std::regex_search(stmt, regex_if_constexpr);
       } else if (strncmp(name, "then_exclude", length) == 0) {
         /* to be excluded if the last constexpr check was positive */
@@ -748,8 +920,7 @@ void CppParser::parse(const std::filesystem::path& filename,
           uint32_t start_line = ts_node_start_point(node).row;
           uint32_t end_line = ts_node_end_point(node).row;
           for (uint32_t line = start_line; line <= end_line; ++line) {
-            if (file.line_counts[line] < 0) {
-              file.line_counts[line] = 0;
+            if (file.line_counts.include(line)) {
               ++file.lines_included;
             }
           }
@@ -784,6 +955,18 @@ Entity& CppParser::pop(const uint32_t start, const uint32_t end) {
     if (back.ingroup.empty()) {
       entities.back().add(std::move(back));
     } else {
+      /* moving to a group, so record the scope from which it is moved, for
+       * its qualified name */
+      for (auto iter = std::next(entities.begin()); iter != entities.end();
+          ++iter) {
+        if (iter->type == EntityType::NAMESPACE ||
+            iter->type == EntityType::TYPE) {
+          if (!back.scope.empty()) {
+            back.scope += "::";
+          }
+          back.scope += iter->name.view();
+        }
+      }
       entities.front().add(std::move(back));
     }
     starts.pop_back();
@@ -859,6 +1042,25 @@ std::string CppParser::preprocess(const std::filesystem::path& filename,
   return in;
 }
 
+std::string CppParser::highlight(const std::string_view in, TSTree* tree) {
+  std::string styles(in.size(), char(Highlight::NONE));
+  TSQueryCursor* cursor = ts_query_cursor_new();
+  ts_query_cursor_exec(cursor, query_highlight, ts_tree_root_node(tree));
+  TSQueryMatch match;
+  uint32_t index;
+  while (ts_query_cursor_next_capture(cursor, &match, &index)) {
+    /* captures are in order of start byte, so that nested captures follow,
+     * and overwrite, those that contain them */
+    TSNode node = match.captures[index].node;
+    Highlight style = capture_styles[match.captures[index].index];
+    uint32_t k = std::min(ts_node_start_byte(node), uint32_t(in.size()));
+    uint32_t l = std::min(ts_node_end_byte(node), uint32_t(in.size()));
+    std::fill(styles.begin() + k, styles.begin() + l, char(style));
+  }
+  ts_query_cursor_delete(cursor);
+  return styles;
+}
+
 void CppParser::report(const std::filesystem::path& filename,
     const std::string_view in, TSTree* tree) {
   TSNode root = ts_tree_root_node(tree);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Entity.hpp"
+#include "Highlight.hpp"
 
 #include <stdint.h>
 #include <tree_sitter/api.h>
@@ -9,6 +10,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 /**
  * C++ source parser.
@@ -19,8 +21,12 @@ class CppParser {
 public:
   /**
    * Constructor.
+   *
+   * @param highlight Record syntax highlighting of sources? If so, each file
+   * parsed is highlighted from its parse tree, and the styles recorded with
+   * its source (see FilePath::styles()).
    */
-  CppParser();
+  CppParser(const bool highlight = false);
 
   /**
    * Destructor.
@@ -76,6 +82,16 @@ private:
   std::string preprocess(const std::filesystem::path& file,
       const std::unordered_map<std::string,std::string>& defines);
 
+  /**
+   * Highlight C++ source.
+   *
+   * @param in Preprocessed source.
+   * @param tree Parse tree for file.
+   *
+   * @return Styles, one Highlight per byte of @p in.
+   */
+  std::string highlight(const std::string_view in, TSTree* tree);
+
   /**
    * Report errors after preprocessing.
    *
@@ -120,4 +136,14 @@ private:
    * C++ inclusions query.
    */
   TSQuery* query_include;
+
+  /**
+   * C++ syntax highlighting query, or null if highlighting is disabled.
+   */
+  TSQuery* query_highlight;
+
+  /**
+   * Syntax highlighting styles, by capture id in `query_highlight`.
+   */
+  std::vector<Highlight> capture_styles;
 };
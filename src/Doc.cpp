@@ -2,6 +2,7 @@
 
 #include "DocTokenizer.hpp"
 #include "Log.hpp"
+#include "SymbolTable.hpp"
 
 #include <algorithm>
 #include <cctype>
@@ -60,8 +61,21 @@ Doc::Doc(const TextLineCursor &comment, const int init_indent) :
           docs.append("\n:material-check-circle-outline: **Post-condition**\n:   ");
         } else if (command == "throw") {
           docs.append("\n:material-alert-circle-outline: **Throw**\n:   ");
-        } else if (command == "see") {
+        } else if (command == "see" ||
+            command == "sa") {
           docs.append("\n:material-eye-outline: **See**\n:   ");
+          see(tokenizer.consume(WORD).view());
+
+          /* further names, e.g. a list separated by commas, up to the end of
+           * the line */
+          while (tokenizer.peek().type & (WORD|WHITESPACE|SENTENCE)) {
+            auto next = tokenizer.next();
+            if (next.type & WORD) {
+              see(next.view());
+            } else {
+              docs.append(next.view());
+            }
+          }
         } else if (command == "anchor") {
           docs.append("<a name=\"");
           docs.append(tokenizer.consume(WORD).view());
@@ -89,8 +103,6 @@ Doc::Doc(const TextLineCursor &comment, const int init_indent) :
         } else if (command == "returns" ||
             command == "result") {
           docs.append("\n:material-location-exit: **Return**\n:   ");
-        } else if (command == "sa") {
-          docs.append("\n:material-eye-outline: **See**\n:   ");
         } else if (command == "file" ||
             command == "internal") {
           hide = true;
@@ -119,11 +131,8 @@ Doc::Doc(const TextLineCursor &comment, const int init_indent) :
         } else if (command == "ref") {
           auto href = tokenizer.consume(WORD);
           auto text = tokenizer.consume(WORD);
-          docs.append("[");
-          docs.append(text.view());
-          docs.append("](#");
-          docs.append(href.view());
-          docs.append(")");
+          docs.append(SymbolTable::marker(SymbolTable::REF, href.view(),
+              text.view()));
         } else if (command == "code" ||
             command == "endcode" ||
             command == "verbatim" ||
@@ -200,3 +209,14 @@ Doc::Doc(const TextLineCursor &comment, const int init_indent) :
     docs.append("\n");
   }
 }
+
+void Doc::see(const std::string_view& word) {
+  /* trailing punctuation, e.g. a comma separating a list of names, or a
+   * period ending a sentence, is not part of the name */
+  auto end = word.find_last_not_of(",;:.");
+  auto name = word.substr(0, end == std::string_view::npos ? 0 : end + 1);
+  if (!name.empty()) {
+    docs.append(SymbolTable::marker(SymbolTable::SEE, name, name));
+  }
+  docs.append(word.substr(name.size()));
+}
@@ -4,6 +4,7 @@
 #include "TextLineCursor.hpp"
 
 #include <string>
+#include <string_view>
 
 /**
  * Documentation of an entity.
@@ -47,4 +48,12 @@ struct Doc {
    * Hide the associated entity?
    */
   bool hide;
+
+private:
+  /**
+   * Append a target of a @@see command, as a cross-reference.
+   *
+   * @param word Word following the command, one of a list.
+   */
+  void see(const std::string_view& word);
 };
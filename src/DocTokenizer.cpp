@@ -57,6 +57,11 @@ DocToken DocTokenizer::next() {
   return token;
 }
 
+DocToken DocTokenizer::peek() const {
+  DocTokenizer copy(*this);
+  return copy.next();
+}
+
 DocToken DocTokenizer::consume(const int stop) {
   DocToken token = next();
   while (token.type && !(token.type & stop)) {
@@ -29,6 +29,13 @@ public:
    */
   DocToken next();
 
+  /**
+   * Get the next token without consuming it.
+   *
+   * @return Next token, as would be returned by next().
+   */
+  DocToken peek() const;
+
   /**
    * Consume tokens until stopping criterion.
    *
@@ -1,18 +1,23 @@
 #include "Driver.hpp"
 
+#include "ContributorMap.hpp"
 #include "CppParser.hpp"
 #include "GcovCounter.hpp"
 #include "JSONCounter.hpp"
+#include "JSONExporter.hpp"
 #include "JSONGenerator.hpp"
 #include "Log.hpp"
 #include "MarkdownGenerator.hpp"
+#include "Snapshot.hpp"
 #include "SourceWatcher.hpp"
 #include "YAMLNode.hpp"
 #include "YAMLParser.hpp"
 #include "doxide.hpp"
 
 #include <glob/glob.hpp>
+#include <charconv>
 #include <chrono>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -222,7 +227,12 @@ R""""(<div class="md-copyright">
 
 Driver::Driver() :
     title("Untitled"),
-    output("docs") {
+    split_members(1000),
+    split_bytes(4000000),
+    highlight(false),
+    templates("templates"),
+    output_format("markdown"),
+    format("json") {
   //
 }
 
@@ -239,6 +249,20 @@ void Driver::init() {
       "site_name: " + title);
   mkdocs_yaml = std::regex_replace(mkdocs_yaml, std::regex("site_description:"),
       "site_description: " + description);
+  if (search == "doxide") {
+    /* replace the search plugin with the search index of Doxide; with no
+     * plugins listed, MkDocs would enable the search plugin by default, so
+     * list none explicitly */
+    doxide_yaml += "search: doxide\n";
+    mkdocs_yaml = std::regex_replace(mkdocs_yaml,
+        std::regex("plugins:\n  - search\n"), "plugins: []\n");
+    mkdocs_yaml = std::regex_replace(mkdocs_yaml,
+        std::regex("  - stylesheets/doxide.css\n"),
+        "  - stylesheets/doxide.css\n  - doxide-search/search.css\n");
+    mkdocs_yaml = std::regex_replace(mkdocs_yaml,
+        std::regex("  - javascripts/tablesort.js\n"),
+        "  - javascripts/tablesort.js\n  - doxide-search/search.js\n");
+  }
 
   write_file_prompt(doxide_yaml, "doxide.yaml");
   write_file_prompt(mkdocs_yaml, "mkdocs.yaml");
@@ -249,17 +273,62 @@ void Driver::init() {
 }
 
 void Driver::build() {
-  config();
-  parse();
-  count();
+  if (!only.empty()) {
+    if (!archive.empty()) {
+      error("--only cannot be used with --archive, as an archive holds all pages of a build.");
+    }
+    load_only();
+    try {
+      MarkdownGenerator generator(output, output_format == "html",
+          split_members, split_bytes, archive, templates);
+      if (!generator.regenerate(root, !coverage.empty(), search == "doxide",
+          only)) {
+        error("no namespace, group or type '" << only << "' to build.");
+      }
+      std::cout << generator.changed() << " of " << generator.pages() <<
+          " pages changed" << std::endl;
+    } catch (const std::runtime_error& e) {
+      error(e.what());
+    }
+    return;
+  }
 
-  MarkdownGenerator generator(output);
-  generator.generate(root, !coverage.empty());
-  generator.clean();
+  load();
+
+  if (!save_snapshot.empty()) {
+    try {
+      Snapshot snap;
+      snap.coverage = coverage;
+      snap.output = output;
+      snap.search = search;
+      snap.split_members = split_members;
+      snap.split_bytes = split_bytes;
+      snap.highlight = highlight;
+      snap.templates = templates;
+      snap.write(save_snapshot, root);
+    } catch (const std::runtime_error& e) {
+      error(e.what());
+    }
+  }
+
+  try {
+    MarkdownGenerator generator(output, output_format == "html",
+        split_members, split_bytes, archive, templates);
+    generator.generate(root, !coverage.empty(), search == "doxide");
+    generator.clean();
+    std::cout << generator.changed() << " of " << generator.pages() <<
+        " pages changed" << std::endl;
+  } catch (const std::runtime_error& e) {
+    error(e.what());
+  }
 }
 
 void Driver::watch() {
-
+  if (!snapshot.empty()) {
+    /* still need the file patterns and macro definitions from the
+     * configuration file, for rebuilding on changes */
+    config();
+  }
   build();
 
   std::cout << "Start watching" << std::endl;
@@ -267,7 +336,7 @@ void Driver::watch() {
   SourceWatcher config_watcher = SourceWatcher(config_file.string());
   SourceWatcher watcher = SourceWatcher(files_patterns);
 
-  CppParser parser;
+  CppParser parser(highlight);
 
   for (;;){
     std::this_thread::sleep_for(std::chrono::milliseconds(2000));
@@ -276,6 +345,8 @@ void Driver::watch() {
       std::cout << std::endl << "Detected configuration file change." << std::endl;
       std::cout << "Rebuilding documentation..." << std::endl;
 
+      /* any snapshot is now stale */
+      snapshot.clear();
       root.clear();
       build();
 
@@ -305,24 +376,34 @@ void Driver::watch() {
       filenames = watcher.filenames();
 
       for (const auto& filename: deleted_files) {
-        root.delete_by_predicate([filename](const Entity& e) {return e.path == filename; });
+        FilePath path(filename);
+        root.remove(path);
+        path.load(std::string());  // release source buffer
       }
       for (const auto& filename: changed_files) {
-        root.delete_by_predicate([filename](const Entity& e) {return e.path == filename; });
+        root.remove(filename);
       }
 
+      /* parse changed and added files together, in order, as parse() would */
+      changed_files.merge(added_files);
       for (const auto& filename: changed_files) {
         parser.parse(filename, defines, root);
       }
-      for (const auto& filename: added_files) {
-        parser.parse(filename, defines, root);
-      }
+      root.reorder();
 
       count();
 
-      MarkdownGenerator generator(output);
-      generator.generate(root, !coverage.empty());
-      generator.clean();
+      try {
+        MarkdownGenerator generator(output, output_format == "html",
+            split_members, split_bytes, archive, templates);
+        generator.generate(root, !coverage.empty(), search == "doxide");
+        generator.clean();
+        std::cout << generator.changed() << " of " << generator.pages() <<
+            " pages changed" << std::endl;
+      } catch (const std::runtime_error& e) {
+        /* keep watching */
+        warn(e.what());
+      }
 
       std::cout << "Done" << std::endl;
     }
@@ -330,16 +411,18 @@ void Driver::watch() {
 }
 
 void Driver::cover() {
-  config();
-  parse();
-  count();
+  load();
 
   JSONGenerator generator;
   generator.generate(root);
 }
 
 void Driver::clean() {
-  config();
+  if (snapshot.empty()) {
+    config();
+  } else {
+    load();
+  }
 
   /* can use MarkdownGenerator::clean() for this just by not calling
    * generate() first; this will remove all files with `generator: doxide` in
@@ -348,6 +431,93 @@ void Driver::clean() {
   generator.clean();
 }
 
+void Driver::exportModel() {
+  load();
+
+  JSONExporter exporter;
+  try {
+    if (export_file.empty()) {
+      exporter.generate(root, std::cout);
+    } else {
+      if (export_file.has_parent_path()) {
+        std::filesystem::create_directories(export_file.parent_path());
+      }
+      std::ofstream out(export_file, std::ios::out | std::ios::binary);
+      if (!out.is_open()) {
+        throw std::runtime_error("could not write file " +
+            export_file.string());
+      }
+      exporter.generate(root, out);
+    }
+  } catch (const std::runtime_error& e) {
+    error(e.what());
+  }
+}
+
+void Driver::load() {
+  if (snapshot.empty()) {
+    config();
+    parse();
+    count();
+  } else {
+    try {
+      Snapshot snap;
+      snap.read(snapshot, root);
+
+      /* options given on the command line take precedence, as do those of
+       * the configuration file if already read, e.g. by watch */
+      if (coverage.empty()) {
+        coverage = snap.coverage;
+      }
+      if (output.empty()) {
+        output = snap.output;
+      }
+      if (search.empty()) {
+        search = snap.search;
+      }
+      if (config_file.empty()) {
+        split_members = snap.split_members;
+        split_bytes = snap.split_bytes;
+        highlight = snap.highlight;
+        templates = snap.templates;
+      }
+    } catch (const std::runtime_error& e) {
+      error(e.what());
+    }
+  }
+}
+
+void Driver::load_only() {
+  if (!snapshot.empty()) {
+    /* nothing to parse */
+    load();
+    return;
+  }
+  config();
+
+  /* parse only the files that contributed to the subtree in the last full
+   * build, and any files that are new since, which may also contribute */
+  ContributorMap contributors(output);
+  std::set<std::string> files;
+  bool found = false;
+  try {
+    found = contributors.load() && contributors.find(only, files);
+  } catch (const std::runtime_error& e) {
+    warn(e.what());
+  }
+  if (found) {
+    std::erase_if(filenames, [&](const std::filesystem::path& path) {
+      const std::string file = path.string();
+      return !files.contains(file) && contributors.known(file);
+    });
+  } else {
+    warn("no record of the files that contribute to '" << only <<
+        "', parsing all files; a full build records them.");
+  }
+  parse();
+  count();
+}
+
 void Driver::config() {
   /* find the configuration file */
   if (std::filesystem::exists("doxide.yaml")) {
@@ -392,6 +562,64 @@ void Driver::config() {
       warn("'output' must be a value in configuration.");
     }
   }
+  if (yaml.has("search")) {
+    if (yaml.isValue("search") && (yaml.value("search") == "mkdocs" ||
+        yaml.value("search") == "doxide")) {
+      search = yaml.value("search");
+    } else {
+      warn("'search' must be 'mkdocs' or 'doxide' in configuration.");
+    }
+  }
+  if (yaml.has("split")) {
+    if (yaml.isMapping("split")) {
+      for (auto& [key, value] : yaml.mapping("split")) {
+        std::size_t* limit = (key == "members") ? &split_members :
+            (key == "bytes") ? &split_bytes : nullptr;
+        if (!limit) {
+          warn("'split' has unknown key '" << key << "' in configuration.");
+          continue;
+        }
+        if (value->isValue()) {
+          const std::string& str = value->value();
+          const char* end = str.data() + str.size();
+          std::size_t n = 0;
+          auto [ptr, ec] = std::from_chars(str.data(), end, n);
+          if (ec == std::errc() && ptr == end && !str.empty()) {
+            *limit = n;
+            continue;
+          }
+        }
+        warn("'split." << key << "' must be a number in configuration.");
+      }
+    } else {
+      warn("'split' must be a mapping in configuration.");
+    }
+  }
+  if (yaml.has("highlight")) {
+    if (yaml.isValue("highlight") && (yaml.value("highlight") == "true" ||
+        yaml.value("highlight") == "false")) {
+      highlight = yaml.value("highlight") == "true";
+    } else {
+      warn("'highlight' must be 'true' or 'false' in configuration.");
+    }
+  }
+  if (yaml.has("templates")) {
+    if (yaml.isValue("templates")) {
+      templates = yaml.value("templates");
+    } else {
+      warn("'templates' must be a value in configuration.");
+    }
+  }
+
+  /* defaults for options given neither on the command line nor in the
+   * configuration file; these are left empty until now so that load() can
+   * tell which were given on the command line */
+  if (output.empty()) {
+    output = "docs";
+  }
+  if (search.empty()) {
+    search = "mkdocs";
+  }
   if (yaml.has("defines")) {
     if (yaml.isMapping("defines")) {
       const auto& map = yaml.mapping("defines");
@@ -435,7 +663,7 @@ void Driver::config() {
 }
 
 void Driver::parse() {
-  CppParser parser;
+  CppParser parser(highlight);
   for (const auto& filename: filenames) {
     parser.parse(filename, defines, root);
   }
@@ -4,9 +4,9 @@
 
 #include <filesystem>
 #include <list>
+#include <set>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 
 class YAMLNode;
 
@@ -47,6 +47,11 @@ public:
    */
   void clean();
 
+  /**
+   * Export the entity model.
+   */
+  void exportModel();
+
   /**
    * Title.
    */
@@ -63,11 +68,95 @@ public:
   std::filesystem::path coverage;
 
   /**
-   * Output directory.
+   * Output directory. Empty until given, or until defaulted to "docs" on
+   * reading the configuration file.
    */
   std::filesystem::path output;
 
+  /**
+   * Snapshot file to load the model from, in place of reading the
+   * configuration file and parsing.
+   */
+  std::filesystem::path snapshot;
+
+  /**
+   * Snapshot file to save the model to, once built.
+   */
+  std::filesystem::path save_snapshot;
+
+  /**
+   * Tar archive to which to write the output of build, in place of the
+   * output directory, if not empty.
+   */
+  std::filesystem::path archive;
+
+  /**
+   * Search: "mkdocs" to use the search plugin of MkDocs, or "doxide" to
+   * generate a search index of entities instead. Empty until given, or until
+   * defaulted to "mkdocs" on reading the configuration file.
+   */
+  std::string search;
+
+  /**
+   * Maximum number of members with details on a page before they are split
+   * over further pages, or zero for no maximum.
+   */
+  std::size_t split_members;
+
+  /**
+   * Maximum estimated size of the details of members on a page, in bytes,
+   * before they are split over further pages, or zero for no maximum.
+   */
+  std::size_t split_bytes;
+
+  /**
+   * Pre-highlight declarations and source listings, rather than leaving
+   * syntax highlighting to MkDocs?
+   */
+  bool highlight;
+
+  /**
+   * Directory of page templates. Templates not found there are built in.
+   */
+  std::filesystem::path templates;
+
+  /**
+   * Subtree to which to restrict build, by the qualified name of a namespace
+   * or type, the name of a group, or the path of its page, or empty to build
+   * everything.
+   */
+  std::string only;
+
+  /**
+   * Output format of build: "markdown" for MkDocs, or "html" for finished
+   * HTML pages.
+   */
+  std::string output_format;
+
+  /**
+   * Export format.
+   */
+  std::string format;
+
+  /**
+   * Export file. If empty, exports to stdout.
+   */
+  std::filesystem::path export_file;
+
 private:
+  /**
+   * Load the model, either from the snapshot file if given, or otherwise by
+   * reading the configuration file, parsing, and counting line coverage.
+   */
+  void load();
+
+  /**
+   * Load the model for a build restricted to a subtree, parsing only the
+   * files that contribute to it, according to the contributor map of the
+   * last full build.
+   */
+  void load_only();
+
   /**
    * Read in the configuration file.
    */
@@ -109,7 +198,8 @@ private:
   std::unordered_map<std::string,std::string> defines;
 
   /**
-   * Files.
+   * Files. These are ordered, so that files are always parsed in the same
+   * order, and identical inputs give identical output.
    */
-  std::unordered_set<std::filesystem::path> filenames;
+  std::set<std::filesystem::path> filenames;
 };
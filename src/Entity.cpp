@@ -1,25 +1,138 @@
 #include "Entity.hpp"
 
+#include "Highlight.hpp"
 #include "Log.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <ostream>
 #include <string_view>
 #include <unordered_set>
 #include <utility>
 
+Entity::list_type Entity::* const Entity::lists[12] = {
+  &Entity::namespaces,
+  &Entity::groups,
+  &Entity::types,
+  &Entity::typedefs,
+  &Entity::concepts,
+  &Entity::variables,
+  &Entity::functions,
+  &Entity::operators,
+  &Entity::enums,
+  &Entity::macros,
+  &Entity::dirs,
+  &Entity::files
+};
+
 Entity::Entity() :
    start_line(0),
    end_line(0),
    lines_included(0),
    lines_covered(0),
+   ndecls(0),
+   parent(nullptr),
    type(EntityType::ROOT),
    visible(false),
    hide(false) {
   //
 }
 
+Entity::Entity(Entity&& o) :
+   namespaces(std::move(o.namespaces)),
+   groups(std::move(o.groups)),
+   types(std::move(o.types)),
+   typedefs(std::move(o.typedefs)),
+   concepts(std::move(o.concepts)),
+   variables(std::move(o.variables)),
+   functions(std::move(o.functions)),
+   operators(std::move(o.operators)),
+   enums(std::move(o.enums)),
+   macros(std::move(o.macros)),
+   dirs(std::move(o.dirs)),
+   files(std::move(o.files)),
+   name(o.name),
+   decl(o.decl),
+   docs(std::move(o.docs)),
+   title(std::move(o.title)),
+   brief(std::move(o.brief)),
+   ingroup(o.ingroup),
+   scope(std::move(o.scope)),
+   path(o.path),
+   start_line(o.start_line),
+   end_line(o.end_line),
+   line_counts(std::move(o.line_counts)),
+   lines_included(o.lines_included),
+   lines_covered(o.lines_covered),
+   ndecls(o.ndecls),
+   declarations(std::move(o.declarations)),
+   parent(o.parent),
+   type(o.type),
+   visible(o.visible),
+   hide(o.hide) {
+  adopt(namespaces);
+  adopt(groups);
+  adopt(types);
+  adopt(typedefs);
+  adopt(concepts);
+  adopt(variables);
+  adopt(functions);
+  adopt(operators);
+  adopt(enums);
+  adopt(macros);
+  adopt(dirs);
+  adopt(files);
+}
+
+Entity& Entity::operator=(Entity&& o) {
+  namespaces = std::move(o.namespaces);
+  groups = std::move(o.groups);
+  types = std::move(o.types);
+  typedefs = std::move(o.typedefs);
+  concepts = std::move(o.concepts);
+  variables = std::move(o.variables);
+  functions = std::move(o.functions);
+  operators = std::move(o.operators);
+  enums = std::move(o.enums);
+  macros = std::move(o.macros);
+  dirs = std::move(o.dirs);
+  files = std::move(o.files);
+  name = o.name;
+  decl = o.decl;
+  docs = std::move(o.docs);
+  title = std::move(o.title);
+  brief = std::move(o.brief);
+  ingroup = o.ingroup;
+  scope = std::move(o.scope);
+  path = o.path;
+  start_line = o.start_line;
+  end_line = o.end_line;
+  line_counts = std::move(o.line_counts);
+  lines_included = o.lines_included;
+  lines_covered = o.lines_covered;
+  ndecls = o.ndecls;
+  declarations = std::move(o.declarations);
+  parent = o.parent;
+  type = o.type;
+  visible = o.visible;
+  hide = o.hide;
+
+  adopt(namespaces);
+  adopt(groups);
+  adopt(types);
+  adopt(typedefs);
+  adopt(concepts);
+  adopt(variables);
+  adopt(functions);
+  adopt(operators);
+  adopt(enums);
+  adopt(macros);
+  adopt(dirs);
+  adopt(files);
+  return *this;
+}
+
 void Entity::add(Entity&& o) {
   if (o.type == EntityType::NAMESPACE && !o.ingroup.empty()) {
     warn("file " << o.path << " line " << o.ingroup.get_line_number() <<
@@ -27,7 +140,7 @@ void Entity::add(Entity&& o) {
     o.ingroup.clear();
   }
   if (!o.ingroup.empty()) {
-    if (addToGroup(std::move(o))) {
+    if (addToGroup(std::move(o), Symbol(o.ingroup.view()))) {
       return;
     } else {
       /* keep track of warnings and don't repeat them */
@@ -42,11 +155,11 @@ void Entity::add(Entity&& o) {
   addToThis(std::move(o));
 }
 
-bool Entity::addToGroup(Entity&& o) {
+bool Entity::addToGroup(Entity&& o, const Symbol& group) {
   /* search for immediate child of given name */
   auto iter = std::find_if(groups.begin(), groups.end(),
-      [&o](const Entity& g) {
-        return g.name == o.ingroup;
+      [&group](const Entity& g) {
+        return g.name == group;
       });
   if (iter != groups.end()) {
     iter->addToThis(std::move(o));
@@ -55,7 +168,7 @@ bool Entity::addToGroup(Entity&& o) {
 
   /* search recursively for descendent of given name */
   for (auto& g : groups) {
-    if (g.addToGroup(std::move(o))) {
+    if (g.addToGroup(std::move(o), group)) {
       return true;
     }
   }
@@ -69,56 +182,63 @@ void Entity::addToThis(Entity&& o) {
           return ns.name == o.name;
         });
     if (iter == namespaces.end()) {
-      namespaces.push_back(std::move(o));
+      place(namespaces, std::move(o));
     } else {
+      /* the namespace is shared, and now also declared by this file */
+      FilePath path = o.path;
       iter->merge(std::move(o));
+      if (!path.empty()) {
+        path.contribute(iter);
+        ++iter->ndecls;
+      }
     }
   } else if (o.type == EntityType::GROUP) {
-    groups.push_back(std::move(o));
+    place(groups, std::move(o));
   } else if (o.type == EntityType::TYPE) {
-    types.push_back(std::move(o));
+    place(types, std::move(o));
   } else if (o.type == EntityType::TYPEDEF) {
-    typedefs.push_back(std::move(o));
+    place(typedefs, std::move(o));
   } else if (o.type == EntityType::CONCEPT) {
-    concepts.push_back(std::move(o));
+    place(concepts, std::move(o));
   } else if (o.type == EntityType::VARIABLE) {
-    variables.push_back(std::move(o));
+    place(variables, std::move(o));
   } else if (o.type == EntityType::FUNCTION) {
-    functions.push_back(std::move(o));
+    place(functions, std::move(o));
   } else if (o.type == EntityType::OPERATOR) {
-    operators.push_back(std::move(o));
+    place(operators, std::move(o));
   } else if (o.type == EntityType::ENUMERATOR) {
-    enums.push_back(std::move(o));
+    place(enums, std::move(o));
   } else if (o.type == EntityType::MACRO) {
-    macros.push_back(std::move(o));
+    place(macros, std::move(o));
   } else if (o.type == EntityType::TEMPLATE) {
     // ignore, likely a parse error within the template declaration
   } else if (o.type == EntityType::FILE || o.type == EntityType::DIR) {
     /* maintain directory structure */
-    std::filesystem::path path = o.path, subdir;
-    path = path.parent_path();
+    std::filesystem::path path = o.path.get().parent_path(), subdir;
     Entity* e = this;
     e->lines_included += o.lines_included;
     e->lines_covered += o.lines_covered;
     for (auto iter = path.begin(); iter != path.end(); ++iter) {
-      auto single = iter->string();
+      Symbol single(iter->string());
       auto found = std::find_if(e->dirs.begin(), e->dirs.end(),
           [&single](auto& s) { return s.name == single; });
-      subdir /= single;
+      subdir /= *iter;
       if (found == e->dirs.end()) {
         /* add subdirectory */
+        Entity* parent = e;
         e = &e->dirs.emplace_back();
+        e->parent = parent;
         e->type = EntityType::DIR;
         e->visible = true;
         e->name = single;
-        e->path = subdir.string();
+        e->path = subdir;
       } else {
         e = &(*found);
       }
       e->lines_included += o.lines_included;
       e->lines_covered += o.lines_covered;
     }
-    e->files.push_back(std::move(o));
+    e->place(e->files, std::move(o));
   } else {
     warn("unrecognized entity type, ignoring");
   }
@@ -126,15 +246,34 @@ void Entity::addToThis(Entity&& o) {
 }
 
 void Entity::merge(Entity&& o) {
-  /* add namespaces via the merging logic of addToThis() */
-  std::for_each(o.namespaces.begin(), o.namespaces.end(),
-      [this](Entity& o) {
-        this->addToThis(std::move(o));
-      });
+  /* add namespaces via the merging logic of addToThis(); any records of
+   * their contribution are forgotten, as they will be destroyed along with o,
+   * and replaced with a new record by addToThis() */
+  for (auto iter = o.namespaces.begin(); iter != o.namespaces.end(); ++iter) {
+    FilePath path = iter->path;
+    for (int i = 0; i < iter->ndecls; ++i) {
+      path.forget(iter);
+    }
+    iter->ndecls = 0;
+    addToThis(std::move(*iter));
+  }
 
+  /* splice in other children; list iterators remain valid, so any record of
+   * their contribution remains valid too */
+  adopt(o.groups);
+  adopt(o.types);
+  adopt(o.typedefs);
+  adopt(o.concepts);
+  adopt(o.variables);
+  adopt(o.functions);
+  adopt(o.operators);
+  adopt(o.macros);
+  adopt(o.enums);
+  adopt(o.dirs);
+  adopt(o.files);
   groups.splice(groups.end(), std::move(o.groups));
   types.splice(types.end(), std::move(o.types));
-  typedefs.splice(types.end(), std::move(o.typedefs));
+  typedefs.splice(typedefs.end(), std::move(o.typedefs));
   concepts.splice(concepts.end(), std::move(o.concepts));
   variables.splice(variables.end(), std::move(o.variables));
   functions.splice(functions.end(), std::move(o.functions));
@@ -144,30 +283,53 @@ void Entity::merge(Entity&& o) {
   dirs.splice(dirs.end(), std::move(o.dirs));
   files.splice(files.end(), std::move(o.files));
 
-  /* merge line counts, recalling that -1 indicates excluded lines, so cannot
-   * simply add the two vectors */
-  end_line = uint32_t(std::max(line_counts.size(), o.line_counts.size()));
-  line_counts.resize(end_line, -1);
-  lines_included = 0;
-  lines_covered = 0;
-  for (uint32_t i = 0; i < end_line; ++i) {
-    int count = (i < o.line_counts.size()) ? o.line_counts[i] : -1;
-    if (line_counts[i] >= 0 || count >= 0) {
-      line_counts[i] = std::max(line_counts[i], 0) + std::max(count, 0);
-      ++lines_included;
-      if (line_counts[i] > 0) {
-        ++lines_covered;
-      }
-    }
+  /* merge line counts */
+  line_counts.merge(o.line_counts);
+  if (type == EntityType::FILE) {
+    end_line = line_counts.size();
+  } else {
+    /* e.g. a template, spanning both the header and the declaration */
+    end_line = std::max(end_line, o.end_line);
   }
+  lines_included = line_counts.nincluded();
+  lines_covered = line_counts.ncovered();
 
   if (ingroup.empty()) {
     ingroup = std::move(o.ingroup);
   }
+  if (type == EntityType::NAMESPACE && o.type == EntityType::NAMESPACE) {
+    /* keep a record of each declaration, inserting its documentation in the
+     * same position, rather than concatenating it below */
+    declare();
+    o.declare();
+    std::string_view o_docs(o.docs), o_brief(o.brief);
+    for (auto& d : o.declarations) {
+      declare(d, o_docs.substr(0, d.docs_size),
+          o_brief.substr(0, d.brief_size));
+      o_docs.remove_prefix(d.docs_size);
+      o_brief.remove_prefix(d.brief_size);
+    }
+    o.docs.clear();
+    o.brief.clear();
+  }
   name = o.name;
   if (type == EntityType::TEMPLATE) {
-    decl += " ";
-    decl += std::move(o.decl);
+    /* the combined declaration is not a slice of the source, so is owned by
+     * the file instead */
+    std::string combined(decl);
+    combined += " ";
+    combined += o.decl;
+
+    /* likewise any syntax highlighting */
+    std::string styles;
+    std::string_view styles1 = path.styles(decl);
+    std::string_view styles2 = o.path.styles(o.decl);
+    if (!styles1.empty() && !styles2.empty()) {
+      styles.append(styles1);
+      styles.push_back(char(Highlight::NONE));
+      styles.append(styles2);
+    }
+    decl = path.own(std::move(combined), std::move(styles));
   }
   docs += std::move(o.docs);
   brief += std::move(o.brief);
@@ -180,7 +342,7 @@ bool Entity::exists(std::filesystem::path& path) const {
   auto parent_path = path.parent_path();
   auto e = this;
   for (auto iter = parent_path.begin(); iter != parent_path.end(); ++iter) {
-    auto single = iter->string();
+    Symbol single(iter->string());
     auto found = std::find_if(e->dirs.begin(), e->dirs.end(),
         [&single](auto& s) { return s.name == single; });
     if (found == e->dirs.end()) {
@@ -190,7 +352,7 @@ bool Entity::exists(std::filesystem::path& path) const {
     }
   }
 
-  auto file = path.filename().string();
+  Symbol file(path.filename().string());
   auto found = std::find_if(e->files.begin(), e->files.end(),
       [&file](auto& s) { return s.name == file; });
   return found != e->files.end();
@@ -202,7 +364,7 @@ std::list<Entity*> Entity::get(std::filesystem::path& path) {
   auto e = this;
   r.push_back(e);
   for (auto iter = parent_path.begin(); iter != parent_path.end(); ++iter) {
-    auto single = iter->string();
+    Symbol single(iter->string());
     auto found = std::find_if(e->dirs.begin(), e->dirs.end(),
         [&single](auto& s) { return s.name == single; });
     assert(found != e->dirs.end());
@@ -210,7 +372,7 @@ std::list<Entity*> Entity::get(std::filesystem::path& path) {
     r.push_back(e);
   }
 
-  auto file = path.filename().string();
+  Symbol file(path.filename().string());
   auto found = std::find_if(e->files.begin(), e->files.end(),
       [&file](auto& s) { return s.name == file; });
   assert(found != e->files.end());
@@ -224,29 +386,182 @@ void Entity::clear() {
   *this = Entity();
 }
 
-void Entity::delete_by_predicate(std::function<bool(const Entity&)> p){
-	std::erase_if(namespaces, p);
-	std::erase_if(groups, p);
-	std::erase_if(types, p);
-	std::erase_if(concepts, p);
-	std::erase_if(variables, p);
-	std::erase_if(functions, p);
-	std::erase_if(operators, p);
-	std::erase_if(enums, p);
-	std::erase_if(macros, p);
-	std::erase_if(dirs, p);
-	std::erase_if(files, p);
-
-	auto r = [p](Entity& e){ e.delete_by_predicate(p); };
-        std::for_each(namespaces.begin(), namespaces.end(), r);
-	std::for_each(groups.begin(), groups.end(), r);
-	std::for_each(types.begin(), types.end(), r);
-	std::for_each(concepts.begin(), concepts.end(), r);
-        std::for_each(variables.begin(), variables.end(), r);
-        std::for_each(functions.begin(), functions.end(), r);
-        std::for_each(operators.begin(), operators.end(), r);
-	std::for_each(enums.begin(), enums.end(), r);
-	std::for_each(macros.begin(), macros.end(), r);
-	std::for_each(dirs.begin(), dirs.end(), r);
-	std::for_each(files.begin(), files.end(), r);
+void Entity::remove(const FilePath& path) {
+  /* contributions are recorded in the order they were added, which is
+   * innermost first, as the parser adds children to their parent before
+   * adding the parent to its own parent; so nested namespaces are
+   * encountered before the namespaces that contain them */
+  for (auto& iter : FilePath(path).release()) {
+    Entity& e = *iter;
+    Entity* parent = e.parent;
+    assert(parent);
+    if (e.type == EntityType::NAMESPACE) {
+      /* only remove once no longer declared by any file, at which point
+       * all contents will have been removed too */
+      if (--e.ndecls > 0) {
+        e.undeclare(path);
+        continue;
+      }
+    } else if (e.type == EntityType::FILE) {
+      /* update coverage counts of directories above */
+      for (Entity* p = parent; p; p = p->parent) {
+        p->lines_included -= e.lines_included;
+        p->lines_covered -= e.lines_covered;
+      }
+    }
+    parent->children(e.type).erase(iter);
+
+    /* remove any directories left empty */
+    while (parent->type == EntityType::DIR && parent->dirs.empty() &&
+        parent->files.empty()) {
+      Entity* dir = parent;
+      parent = dir->parent;
+      parent->dirs.remove_if([dir](const Entity& d) { return &d == dir; });
+    }
+  }
+}
+
+void Entity::reorder() {
+  auto by_file = [](const Entity& a, const Entity& b) {
+    return a.path.get() < b.path.get();
+  };
+  for (auto list : lists) {
+    auto& children = this->*list;
+    if (!std::is_sorted(children.begin(), children.end(), by_file)) {
+      /* stable, and iterators remain valid, as do records of contributions */
+      children.sort(by_file);
+    }
+    for (auto& child : children) {
+      if (child.type == EntityType::NAMESPACE ||
+          child.type == EntityType::GROUP ||
+          child.type == EntityType::DIR) {
+        child.reorder();
+      }
+    }
+  }
+}
+
+void Entity::place(list_type& list, Entity&& o) {
+  FilePath path = o.path;
+  bool shared = type == EntityType::ROOT ||
+      type == EntityType::NAMESPACE ||
+      type == EntityType::GROUP ||
+      type == EntityType::DIR;
+
+  list.push_back(std::move(o));
+  auto iter = std::prev(list.end());
+  iter->parent = this;
+
+  /* record the contribution of the file, but only when adding to an entity
+   * that is shared between files; the contributions of the file to this
+   * entity's own children, if any, are then implied, and are removed along
+   * with it */
+  if (shared && !path.empty()) {
+    path.contribute(iter);
+    if (iter->type == EntityType::NAMESPACE) {
+      ++iter->ndecls;
+    }
+  }
+}
+
+Entity::list_type& Entity::children(const EntityType type) {
+  switch (type) {
+  case EntityType::NAMESPACE: return namespaces;
+  case EntityType::GROUP: return groups;
+  case EntityType::TYPE: return types;
+  case EntityType::TYPEDEF: return typedefs;
+  case EntityType::CONCEPT: return concepts;
+  case EntityType::VARIABLE: return variables;
+  case EntityType::FUNCTION: return functions;
+  case EntityType::OPERATOR: return operators;
+  case EntityType::ENUMERATOR: return enums;
+  case EntityType::MACRO: return macros;
+  case EntityType::DIR: return dirs;
+  case EntityType::FILE: return files;
+  default:
+    assert(false);
+    return namespaces;
+  }
+}
+
+void Entity::adopt(list_type& list) {
+  for (auto& child : list) {
+    child.parent = this;
+  }
+}
+
+void Entity::declare() {
+  if (declarations.empty()) {
+    declarations.push_back(Declaration{path, decl, start_line, end_line,
+        docs.size(), brief.size()});
+  }
+}
+
+void Entity::declare(const Declaration& d, const std::string_view& docs,
+    const std::string_view& brief) {
+  /* in order of file, as for a full build, which parses files in order;
+   * there, each declaration is usually of the last file so far, and is
+   * simply appended */
+  auto by_file = [](const Declaration& a, const Declaration& b) {
+    return a.path.get() < b.path.get();
+  };
+  auto iter = declarations.end();
+  std::size_t docs_pos = this->docs.size(), brief_pos = this->brief.size();
+  if (!declarations.empty() && by_file(d, declarations.back())) {
+    iter = std::upper_bound(declarations.begin(), declarations.end(), d,
+        by_file);
+    docs_pos = 0;
+    brief_pos = 0;
+    for (auto d1 = declarations.begin(); d1 != iter; ++d1) {
+      docs_pos += d1->docs_size;
+      brief_pos += d1->brief_size;
+    }
+  }
+  this->docs.insert(docs_pos, docs);
+  this->brief.insert(brief_pos, brief);
+  iter = declarations.insert(iter, d);
+
+  /* a declaration of an earlier file becomes the primary one */
+  if (iter == declarations.begin()) {
+    path = d.path;
+    decl = d.decl;
+    start_line = d.start_line;
+    end_line = d.end_line;
+  }
+}
+
+void Entity::undeclare(const FilePath& file) {
+  /* remove the declarations of the file, and the parts of the documentation
+   * that they contributed, which are at the same positions in the
+   * concatenation */
+  declare();
+  std::size_t docs_pos = 0, brief_pos = 0;
+  auto last = declarations.begin();
+  for (auto& d : declarations) {
+    if (d.path == file) {
+      docs.erase(docs_pos, d.docs_size);
+      brief.erase(brief_pos, d.brief_size);
+    } else {
+      docs_pos += d.docs_size;
+      brief_pos += d.brief_size;
+      *last++ = d;
+    }
+  }
+  declarations.erase(last, declarations.end());
+
+  /* the first remaining declaration becomes the primary one; if none remain,
+   * the file declared the namespace more than once, and the remaining
+   * records of its contribution are about to be released too */
+  if (declarations.empty()) {
+    path = FilePath();
+    decl = std::string_view();
+    start_line = 0;
+    end_line = 0;
+  } else {
+    auto& first = declarations.front();
+    path = first.path;
+    decl = first.decl;
+    start_line = first.start_line;
+    end_line = first.end_line;
+  }
 }
@@ -1,13 +1,17 @@
 #pragma once
 
+#include "FilePath.hpp"
+#include "LineCounts.hpp"
+#include "Symbol.hpp"
 #include "TextLineCursor.hpp"
 
 #include <filesystem>
 #include <list>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
 
 /**
  * Entity types.
@@ -43,11 +47,60 @@ struct Entity {
    */
   using list_type = std::list<Entity>;
 
+  /**
+   * Declaration of a namespace in a source file. A namespace may be declared
+   * in many files, and this records what each declaration contributed, so
+   * that it can be withdrawn when the file is removed.
+   */
+  struct Declaration {
+    /**
+     * Path of source file.
+     */
+    FilePath path;
+
+    /**
+     * Declaration, as a view of the source buffer of the file.
+     */
+    std::string_view decl;
+
+    /**
+     * Starting line in the source file.
+     */
+    uint32_t start_line;
+
+    /**
+     * Ending line in the source file.
+     */
+    uint32_t end_line;
+
+    /**
+     * Length of the documentation contributed, within the documentation of
+     * the namespace.
+     */
+    std::size_t docs_size;
+
+    /**
+     * Length of the brief description contributed, within the brief
+     * description of the namespace.
+     */
+    std::size_t brief_size;
+  };
+
   /**
    * Constructor.
   */
   Entity();
 
+  /**
+   * Move constructor. Children are reparented to the new entity.
+   */
+  Entity(Entity&& o);
+
+  /**
+   * Move assignment. Children are reparented to this entity.
+   */
+  Entity& operator=(Entity&& o);
+
   /**
    * Add child entity.
    *
@@ -89,11 +142,45 @@ struct Entity {
   void clear();
 
   /**
-   * Recursively delete all child entities that satisfy the predicate.
+   * Remove all entities contributed by a file.
    *
-   * @param p Predicate.
+   * @param path File path.
+   *
+   * This is called on the root entity. It uses the record of entities
+   * contributed by the file that is kept by FilePath, so touches only those
+   * entities and their ancestors, rather than traversing the whole model.
+   * Namespaces are shared between files, and are removed only once the last
+   * file to declare them is removed. Coverage counts of the directories
+   * above a removed file are updated, and any directories left empty are
+   * removed.
+   */
+  void remove(const FilePath& path);
+
+  /**
+   * Restore the order of entities to that of a full build, after files have
+   * been removed and parsed again.
+   *
+   * This is called on the root entity. Entities added since a full build are
+   * at the end of the lists of the namespaces, groups and directories that
+   * they share with other files. A full build parses files in order, so that
+   * these lists are in the order of files, and within each file in the order
+   * parsed, which is restored by a stable sort by file. Lists already in
+   * order are not sorted.
+   */
+  void reorder();
+
+  /**
+   * Get the list of children of a given type.
+   *
+   * @param type Entity type.
    */
-  void delete_by_predicate(std::function<bool(const Entity&)> p);
+  list_type& children(const EntityType type);
+
+  /**
+   * Pointers to the lists of children, in the order that they are declared
+   * below. Used to visit all children in a fixed order.
+   */
+  static list_type Entity::* const lists[12];
 
   /**
    * Child namespaces.
@@ -159,13 +246,14 @@ struct Entity {
    * Entity name (e.g. name of variable, function, class). For a file or
    * directory this is the full path.
    */
-  std::string name;
+  Symbol name;
 
   /**
    * Entity declaration (e.g. function signature). For a file this is its full
-   * contents.
+   * contents. This is a view of the source buffer of the file, owned by
+   * `path`.
    */
-  std::string decl;
+  std::string_view decl;
 
   /**
    * Entity documentation.
@@ -187,10 +275,17 @@ struct Entity {
    */
   TextLineCursor ingroup;
 
+  /**
+   * For an entity moved into a group by `@ingroup`, the qualified name of
+   * the scope from which it was moved, e.g. `ns::inner`, as groups are not
+   * C++ scopes. Empty otherwise.
+   */
+  std::string scope;
+
   /**
    * Path of source file.
    */
-  std::filesystem::path path;
+  FilePath path;
 
   /**
    * Starting line in the source file.
@@ -203,10 +298,9 @@ struct Entity {
   uint32_t end_line;
 
   /**
-   * For a file only, execution counts for lines. -1 for a line indicates that
-   * it is excluded.
+   * For a file only, execution counts for lines.
    */
-  std::vector<int> line_counts;
+  LineCounts line_counts;
 
   /**
    * Number of lines included in coverage counts.
@@ -218,6 +312,29 @@ struct Entity {
    */
   int lines_covered;
 
+  /**
+   * For a namespace only, the number of declarations of it contributed to
+   * the model, across all files.
+   */
+  int ndecls;
+
+  /**
+   * For a namespace only, its declarations, in the order of their files (see
+   * declare()). The `path`, `decl`, `start_line` and `end_line` of the
+   * namespace are those of the first, and its `docs` and `brief` the
+   * concatenation of theirs. Empty until a second declaration is merged, as
+   * a namespace with a single declaration needs no more than its own
+   * fields.
+   */
+  std::vector<Declaration> declarations;
+
+  /**
+   * Parent entity, or `nullptr` if none. This is set once the entity has
+   * been added to a parent, and is maintained as entities are moved and
+   * merged.
+   */
+  Entity* parent;
+
   /**
    * Entity type.
    */
@@ -239,11 +356,12 @@ private:
    * Add child entity to a group.
    *
    * @param o Child entity with `ingroup` set.
+   * @param group Name of the group, interned from `o.ingroup`.
    *
    * @return True if a group of the given name was found, in which case @p o
    * will have been added to it, false otherwise.
    */
-  bool addToGroup(Entity&& o);
+  bool addToGroup(Entity&& o, const Symbol& group);
 
   /**
    * Add child entity.
@@ -253,4 +371,46 @@ private:
    * If the child has `ingroup` set, it is ignored.
    */
   void addToThis(Entity&& o);
+
+  /**
+   * Add child entity to one of the lists of children, recording the
+   * contribution of its file.
+   *
+   * @param list List of children.
+   * @param o Child entity.
+   */
+  void place(list_type& list, Entity&& o);
+
+  /**
+   * Set this as the parent of the entities in a list.
+   */
+  void adopt(list_type& list);
+
+  /**
+   * For a namespace, record its own fields as its single declaration, if it
+   * has no record of declarations yet.
+   */
+  void declare();
+
+  /**
+   * For a namespace, record a further declaration, along with the
+   * documentation and brief description that it contributes. Declarations
+   * are kept in the order of their files, as parsed by a full build, and
+   * the first is the primary declaration.
+   *
+   * @param d Declaration.
+   * @param docs Documentation contributed.
+   * @param brief Brief description contributed.
+   */
+  void declare(const Declaration& d, const std::string_view& docs,
+      const std::string_view& brief);
+
+  /**
+   * For a namespace, withdraw its declarations in a file, along with the
+   * documentation that they contributed. If the first declaration is
+   * withdrawn, the next becomes the first.
+   *
+   * @param file Source file.
+   */
+  void undeclare(const FilePath& file);
 };
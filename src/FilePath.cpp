@@ -0,0 +1,180 @@
+#include "FilePath.hpp"
+
+#include "Entity.hpp"
+
+#include <deque>
+#include <functional>
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Table of interned file paths.
+ *
+ * @ingroup developer
+ */
+struct FileTable {
+  /**
+   * Record for a single file.
+   */
+  struct Record {
+    Record() = default;
+    Record(const std::filesystem::path& path) :
+        path(path) {
+      //
+    }
+
+    /**
+     * Path.
+     */
+    std::filesystem::path path;
+
+    /**
+     * Preprocessed source.
+     */
+    std::string source;
+
+    /**
+     * Strings derived from the source. A list is used so that existing
+     * strings are not relocated, invalidating views of them, on insertion.
+     */
+    std::list<std::string> derived;
+
+    /**
+     * Syntax highlighting of the source, one Highlight per byte, or empty if
+     * not highlighted.
+     */
+    std::string styles;
+
+    /**
+     * Syntax highlighting of strings derived from the source, by address of
+     * their contents.
+     */
+    std::unordered_map<const char*,std::string> derived_styles;
+
+    /**
+     * Entities contributed to the model.
+     */
+    std::vector<FilePath::entity_iterator> entities;
+  };
+
+  FileTable() {
+    /* the empty path is always index zero */
+    records.emplace_back();
+    ids.emplace(std::string(), 0);
+  }
+
+  uint32_t intern(const std::filesystem::path& path) {
+    auto [iter, inserted] = ids.try_emplace(path.string(),
+        uint32_t(records.size()));
+    if (inserted) {
+      records.emplace_back(path);
+    }
+    return iter->second;
+  }
+
+  /**
+   * Records, by index.
+   */
+  std::deque<Record> records;
+
+  /**
+   * Indices, by path string.
+   */
+  std::unordered_map<std::string,uint32_t> ids;
+};
+
+/**
+ * Get the run-wide file table.
+ *
+ * @ingroup developer
+ */
+static FileTable& table() {
+  static FileTable t;
+  return t;
+}
+
+FilePath::FilePath() :
+    _id(0) {
+  //
+}
+
+FilePath::FilePath(const std::filesystem::path& path) :
+    _id(path.empty() ? 0 : table().intern(path)) {
+  //
+}
+
+const std::filesystem::path& FilePath::get() const {
+  return table().records[_id].path;
+}
+
+std::string_view FilePath::load(std::string&& source) {
+  auto& record = table().records[_id];
+  record.source = std::move(source);
+  record.derived.clear();
+  record.styles.clear();
+  record.derived_styles.clear();
+  record.entities.clear();
+  return record.source;
+}
+
+std::string_view FilePath::source() const {
+  return table().records[_id].source;
+}
+
+void FilePath::highlight(std::string&& styles) {
+  auto& record = table().records[_id];
+  if (styles.size() == record.source.size()) {
+    record.styles = std::move(styles);
+  }
+}
+
+std::string_view FilePath::styles(const std::string_view& str) const {
+  auto& record = table().records[_id];
+  std::less_equal<const char*> le;
+  const char* begin = record.source.data();
+  const char* end = begin + record.source.size();
+  if (!record.styles.empty() && le(begin, str.data()) &&
+      le(str.data() + str.size(), end)) {
+    return std::string_view(record.styles).substr(str.data() - begin,
+        str.size());
+  }
+  auto iter = record.derived_styles.find(str.data());
+  if (iter != record.derived_styles.end() &&
+      iter->second.size() == str.size()) {
+    return iter->second;
+  }
+  return std::string_view();
+}
+
+std::string_view FilePath::own(std::string&& str, std::string&& styles) {
+  auto& record = table().records[_id];
+  std::string_view view = record.derived.emplace_back(std::move(str));
+  if (!styles.empty() && styles.size() == view.size()) {
+    record.derived_styles[view.data()] = std::move(styles);
+  }
+  return view;
+}
+
+void FilePath::contribute(const entity_iterator& iter) {
+  table().records[_id].entities.push_back(iter);
+}
+
+void FilePath::forget(const entity_iterator& iter) {
+  /* search from the back, as the most recent contributions are the most
+   * likely to be forgotten */
+  auto& entities = table().records[_id].entities;
+  auto found = std::find(entities.rbegin(), entities.rend(), iter);
+  if (found != entities.rend()) {
+    entities.erase(std::next(found).base());
+  }
+}
+
+std::vector<FilePath::entity_iterator> FilePath::release() {
+  return std::exchange(table().records[_id].entities, {});
+}
+
+const std::vector<FilePath::entity_iterator>& FilePath::contributions() const {
+  return table().records[_id].entities;
+}
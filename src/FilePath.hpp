@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Entity;
+
+/**
+ * Interned file path, used for the paths of entities.
+ *
+ * @ingroup developer
+ *
+ * Each distinct path is stored once in a run-wide file table, and a FilePath
+ * holds only its index into that table. Every entity parsed from a source
+ * file records the path of that file; interning means the path is stored
+ * once per file rather than once per entity, and equality comparisons reduce
+ * to integer comparisons. The empty path always has index zero.
+ *
+ * The file table also serves as the store of source buffers. It owns the
+ * preprocessed source of each file, once, and entity declarations are views
+ * of slices of it. Any strings derived from the source that are not slices
+ * of it (e.g. the combined declaration of a template) are owned by the same
+ * file, so that all are released together when the file is reloaded. The
+ * same goes for the syntax highlighting of the source and of any derived
+ * strings, where enabled.
+ *
+ * Finally, the file table records which entities each file contributed to
+ * the model, so that they can be removed again without traversing the whole
+ * model (see Entity::remove()).
+ */
+class FilePath {
+public:
+  /**
+   * Iterator to an entity contributed by the file.
+   */
+  using entity_iterator = std::list<Entity>::iterator;
+
+  /**
+   * Construct the empty path.
+   */
+  FilePath();
+
+  /**
+   * Constructor.
+   *
+   * @param path Path to intern.
+   */
+  FilePath(const std::filesystem::path& path);
+
+  /**
+   * Get the path.
+   */
+  const std::filesystem::path& get() const;
+
+  /**
+   * Get the path.
+   */
+  operator const std::filesystem::path&() const {
+    return get();
+  }
+
+  /**
+   * Get the path as a string.
+   */
+  std::string string() const {
+    return get().string();
+  }
+
+  /**
+   * Set the source of the file, replacing any previous source along with any
+   * strings derived from it and any record of entities contributed by it.
+   * Views of the previous source are invalidated.
+   *
+   * @param source Preprocessed source.
+   *
+   * @return View of the source, valid until the next call to `load()` for
+   * the same file.
+   */
+  std::string_view load(std::string&& source);
+
+  /**
+   * Get the source of the file, as set by `load()`.
+   */
+  std::string_view source() const;
+
+  /**
+   * Set the syntax highlighting of the source of the file, as set by
+   * `load()`.
+   *
+   * @param styles Styles, one Highlight per byte of the source.
+   */
+  void highlight(std::string&& styles);
+
+  /**
+   * Get the syntax highlighting of a view of the source of the file, or of a
+   * string derived from it.
+   *
+   * @param str View of the source, or of a derived string as returned by
+   * `own()`.
+   *
+   * @return Styles, one Highlight per byte of @p str, or empty if the string
+   * is not highlighted.
+   */
+  std::string_view styles(const std::string_view& str) const;
+
+  /**
+   * Take ownership of a string derived from the source of the file.
+   *
+   * @param str Derived string.
+   * @param styles Syntax highlighting of the derived string, one Highlight
+   * per byte, or empty if not highlighted.
+   *
+   * @return View of the string, valid until the next call to `load()` for the
+   * same file.
+   */
+  std::string_view own(std::string&& str, std::string&& styles = {});
+
+  /**
+   * Record that the file contributed an entity to the model.
+   *
+   * @param iter Iterator to the entity in the list of its parent.
+   */
+  void contribute(const entity_iterator& iter);
+
+  /**
+   * Remove the most recent record of a contribution made with
+   * `contribute()`, if any.
+   *
+   * @param iter Iterator to the entity in the list of its parent.
+   */
+  void forget(const entity_iterator& iter);
+
+  /**
+   * Remove and return all records of contributions made with `contribute()`
+   * since the last call to `load()`.
+   *
+   * @return Iterators to the entities, in the order that they were
+   * contributed.
+   */
+  std::vector<entity_iterator> release();
+
+  /**
+   * Get all records of contributions made with `contribute()` since the last
+   * call to `load()`, in the order that they were contributed.
+   */
+  const std::vector<entity_iterator>& contributions() const;
+
+  /**
+   * Index into the table.
+   */
+  uint32_t id() const {
+    return _id;
+  }
+
+  /**
+   * Is this the empty path?
+   */
+  bool empty() const {
+    return _id == 0;
+  }
+
+  /**
+   * Equality comparison, by index.
+   */
+  friend bool operator==(const FilePath& a, const FilePath& b) {
+    return a._id == b._id;
+  }
+
+private:
+  /**
+   * Index into the table.
+   */
+  uint32_t _id;
+};
+
+/**
+ * Allows printing the path `v` into the stream `s`.
+ */
+inline std::ostream& operator<<(std::ostream& s, const FilePath& v) {
+  return s << v.get();
+}
+
+/**
+ * Hash of a path, which is just its index.
+ */
+template<>
+struct std::hash<FilePath> {
+  std::size_t operator()(const FilePath& v) const noexcept {
+    return v.id();
+  }
+};
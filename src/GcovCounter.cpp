@@ -77,7 +77,7 @@ void GcovCounter::count(const std::filesystem::path& coverage, Entity& root) {
     } else if (include && std::regex_match(line, match, regex_covered)) {
       /* line data */
       int line_number = std::stoi(match[2]) - 1;
-      int count = std::stoi(match[1]);
+      uint64_t count = std::stoull(match[1]);
       if (line_number < 0 || size_t(line_number) >= nlines) {
         warn("in " << file << ", " << path << ":" << line_number <<
             " does not exist; ignoring, are source and coverage" <<
@@ -86,18 +86,13 @@ void GcovCounter::count(const std::filesystem::path& coverage, Entity& root) {
         // ^ the check against max_line_number means skipping lines with
         //   disaggregated counts that have already been accounted for in
         //   aggregated counts
-        int& line_count = file->line_counts[line_number];
-        if (line_count == 0) {
+        if (file->line_counts.add(line_number, count)) {
           /* line is included in report and first time seeing it covered,
            * update aggregate counts for whole path */
           for (auto e : es) {
             ++e->lines_covered;
           }
         }
-        if (line_count >= 0) {
-          /* line is included in report, update count */
-          line_count += count;
-        }
       }
       max_line_number = std::max(max_line_number, line_number);
     }
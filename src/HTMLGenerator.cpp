@@ -0,0 +1,420 @@
+#include "HTMLGenerator.hpp"
+#include "HTMLRenderer.hpp"
+#include "Log.hpp"
+
+/**
+ * Style sheet shared by all pages, written to the assets directory.
+ *
+ * @ingroup developer
+ */
+static const char* html_css = R""""(/* Doxide */
+:root {
+  --doxide-primary: #ef5552;
+  --doxide-fg: rgba(0, 0, 0, 0.87);
+  --doxide-fg-light: rgba(0, 0, 0, 0.54);
+  --doxide-fg-lighter: rgba(0, 0, 0, 0.12);
+  --doxide-bg: white;
+  --doxide-code-bg: #f5f5f5;
+  --md-default-fg-color: var(--doxide-fg);
+  --md-default-bg-color: var(--doxide-bg);
+  --md-code-font-family: ui-monospace, SFMono-Regular, Menlo, Consolas, monospace;
+}
+@media (prefers-color-scheme: dark) {
+  :root {
+    --doxide-fg: rgba(226, 228, 233, 0.82);
+    --doxide-fg-light: rgba(226, 228, 233, 0.56);
+    --doxide-fg-lighter: rgba(226, 228, 233, 0.16);
+    --doxide-bg: #1e2129;
+    --doxide-code-bg: #262a33;
+  }
+}
+body {
+  margin: 0;
+  background-color: var(--doxide-bg);
+  color: var(--doxide-fg);
+  font-family: system-ui, -apple-system, "Segoe UI", Roboto, sans-serif;
+  font-size: 16px;
+  line-height: 1.6;
+}
+a {
+  color: var(--doxide-primary);
+  text-decoration: none;
+}
+a:hover {
+  text-decoration: underline;
+}
+.md-header {
+  background-color: var(--doxide-primary);
+  color: white;
+}
+.md-header__inner {
+  display: flex;
+  align-items: center;
+  max-width: 61rem;
+  margin: 0 auto;
+  padding: 0.6rem 1rem;
+}
+.md-header__title {
+  flex-grow: 1;
+  color: white;
+  font-size: 1.2rem;
+  font-weight: bold;
+}
+.doxide-breadcrumbs, .md-typeset, .doxide-footer {
+  max-width: 61rem;
+  margin: 0 auto;
+  padding: 0 1rem;
+}
+.doxide-breadcrumbs {
+  padding-top: 0.8rem;
+  color: var(--doxide-fg-light);
+  font-size: 0.85rem;
+}
+.doxide-footer {
+  padding-top: 2rem;
+  padding-bottom: 2rem;
+  color: var(--doxide-fg-light);
+  font-size: 0.8rem;
+}
+.md-typeset h1 {
+  font-weight: 300;
+  color: var(--doxide-fg-light);
+}
+.md-typeset code, .md-typeset pre {
+  font-family: var(--md-code-font-family);
+  font-size: 0.85em;
+  background-color: var(--doxide-code-bg);
+  border-radius: 0.1rem;
+}
+.md-typeset code {
+  padding: 0 0.3em;
+}
+.md-typeset pre {
+  margin: 0;
+  padding: 0.8em 1em;
+  overflow-x: auto;
+}
+.md-typeset pre code {
+  padding: 0;
+}
+.md-typeset .highlight {
+  margin: 1em 0;
+}
+.md-typeset .highlighttable {
+  border-collapse: collapse;
+  width: 100%;
+}
+.md-typeset .highlighttable td {
+  padding: 0;
+  border: none;
+  vertical-align: top;
+}
+.md-typeset .highlighttable .linenos {
+  width: 1%;
+  text-align: right;
+  color: var(--doxide-fg-light);
+  user-select: none;
+}
+.md-typeset .highlighttable .linenos pre {
+  padding-right: 0.6em;
+}
+.md-typeset .highlighttable .linenos .normal {
+  padding: 0 0.3em;
+}
+.md-typeset .c, .md-typeset .cp, .md-typeset .cpf {
+  color: var(--doxide-fg-light);
+}
+.md-typeset .k, .md-typeset .kc, .md-typeset .kt {
+  color: #3f6ec6;
+}
+.md-typeset .s, .md-typeset .sc, .md-typeset .se, .md-typeset .m {
+  color: #1c7d4d;
+}
+.md-typeset .nc, .md-typeset .nf, .md-typeset .nn {
+  color: #a846b9;
+}
+.md-typeset table:not(.highlighttable) {
+  border-collapse: collapse;
+  margin: 1em 0;
+  font-size: 0.85em;
+}
+.md-typeset table:not(.highlighttable) th,
+.md-typeset table:not(.highlighttable) td {
+  padding: 0.4em 0.8em;
+  border-top: 1px solid var(--doxide-fg-lighter);
+  text-align: left;
+}
+.md-typeset th[role=columnheader] {
+  cursor: pointer;
+}
+.md-typeset dt {
+  font-weight: bold;
+}
+.md-typeset dd {
+  margin: 0 0 1em 1.6em;
+}
+.md-typeset .admonition, .md-typeset details {
+  margin: 1.2em 0;
+  padding: 0 0.8em;
+  border: 1px solid var(--doxide-fg-lighter);
+  border-left: 0.2rem solid var(--doxide-fg-light);
+  border-radius: 0.1rem;
+}
+.md-typeset .admonition-title, .md-typeset summary {
+  margin: 0 -0.8em;
+  padding: 0.4em 0.8em;
+  font-weight: bold;
+  background-color: var(--doxide-fg-lighter);
+}
+.md-typeset summary {
+  cursor: pointer;
+}
+.md-typeset details[open] > summary {
+  margin-bottom: 0.6em;
+}
+.md-typeset .note, .md-typeset .info, .md-typeset .abstract {
+  border-left-color: #448aff;
+}
+.md-typeset .tip, .md-typeset .success {
+  border-left-color: #00bfa5;
+}
+.md-typeset .warning, .md-typeset .question {
+  border-left-color: #ff9100;
+}
+.md-typeset .danger, .md-typeset .failure, .md-typeset .bug {
+  border-left-color: #ff1744;
+}
+.md-typeset .variable > .admonition-title, .md-typeset .variable > summary,
+.md-typeset .function > .admonition-title, .md-typeset .function > summary,
+.md-typeset .typedef > .admonition-title, .md-typeset .typedef > summary,
+.md-typeset .concept > .admonition-title, .md-typeset .concept > summary,
+.md-typeset .macro > .admonition-title, .md-typeset .macro > summary {
+  background-color: var(--doxide-bg);
+  font-family: var(--md-code-font-family);
+  font-weight: normal;
+}
+.md-typeset blockquote {
+  margin: 1em 0;
+  padding-left: 0.8em;
+  border-left: 0.2rem solid var(--doxide-fg-lighter);
+  color: var(--doxide-fg-light);
+}
+.doxide-icon {
+  display: inline-block;
+  min-width: 1.2em;
+  color: var(--doxide-fg-light);
+  text-align: center;
+}
+)"""";
+
+/**
+ * Script shared by all pages, written to the assets directory. Configures
+ * MathJax, if loaded after it, and makes tables sortable, as the scripts
+ * written by `doxide init` do for MkDocs.
+ *
+ * @ingroup developer
+ */
+static const char* html_js = R""""(/* Doxide */
+window.MathJax = {
+  tex: {
+    inlineMath: [["\\(", "\\)"]],
+    displayMath: [["\\[", "\\]"]],
+    processEscapes: true,
+    processEnvironments: true
+  },
+  options: {
+    ignoreHtmlClass: ".*|",
+    processHtmlClass: "arithmatex"
+  }
+};
+
+if (typeof Tablesort !== 'undefined') {
+  document.querySelectorAll("article table:not([class])").forEach(table => {
+    new Tablesort(table);
+  });
+}
+)"""";
+
+/**
+ * Append a string to HTML output, escaping special characters.
+ *
+ * @ingroup developer
+ */
+static void escape(const std::string_view& str, std::string& out) {
+  for (char c : str) {
+    switch (c) {
+    case '&': out += "&amp;"; break;
+    case '<': out += "&lt;"; break;
+    case '>': out += "&gt;"; break;
+    case '"': out += "&quot;"; break;
+    default: out += c;
+    }
+  }
+}
+
+HTMLGenerator::HTMLGenerator(const std::filesystem::path& output) :
+    output(output) {
+  //
+}
+
+std::filesystem::path HTMLGenerator::file(
+    const std::filesystem::path& md) const {
+  if (md.filename() == "index.md") {
+    return md.parent_path() / "index.html";
+  } else {
+    std::filesystem::path stem = md;
+    stem.replace_extension();
+    return stem / "index.html";
+  }
+}
+
+std::string HTMLGenerator::url(const std::filesystem::path& md) const {
+  std::string u = file(md).parent_path().lexically_relative(output).
+      generic_string();
+  return u == "." || u.empty() ? "" : u + "/";
+}
+
+std::string HTMLGenerator::link(const std::filesystem::path& md,
+    const std::string_view& target) const {
+  /* leave absolute URLs and anchors on the same page as they are */
+  if (target.empty() || target[0] == '#' || target[0] == '/' ||
+      target.find("://") != std::string_view::npos ||
+      target.starts_with("mailto:")) {
+    return std::string(target);
+  }
+  std::size_t hash = target.find_first_of("?#");
+  std::string_view path = target.substr(0, hash);
+  std::string_view rest = hash == std::string_view::npos ?
+      std::string_view() : target.substr(hash);
+
+  /* resolve against the Markdown page, then make relative to the URL of the
+   * HTML page, which may be one level deeper */
+  std::filesystem::path from = output / url(md);
+  std::filesystem::path to = (md.parent_path() / path).lexically_normal();
+  bool dir = path.ends_with('/');
+  if (to.extension() == ".md") {
+    to = output / url(to);
+    dir = true;
+  }
+  std::string rel = to.lexically_relative(from).generic_string();
+  if (rel == "." || rel.empty()) {
+    rel = dir ? "./" : "";
+  } else if (dir && !rel.ends_with('/')) {
+    rel += '/';
+  }
+  return rel + std::string(rest);
+}
+
+std::string HTMLGenerator::page(const std::filesystem::path& md,
+    const std::string_view& markdown, const std::string& site,
+    const bool search) const {
+  /* skip YAML frontmatter */
+  std::string_view body = markdown;
+  if (body.starts_with("---\n")) {
+    std::size_t end = body.find("\n---\n", 3);
+    if (end != std::string_view::npos) {
+      body.remove_prefix(end + 5);
+    }
+  }
+
+  HTMLRenderer renderer([&](const std::string_view& target) {
+    return link(md, target);
+  });
+  std::string content = renderer.render(body);
+  if (!renderer.unsupported().empty()) {
+    /* pages are rendered concurrently; warn once per construct */
+    std::lock_guard lock(mutex);
+    for (auto& construct : renderer.unsupported()) {
+      if (warned.insert(construct).second) {
+        warn(md.string() << ": " << construct << " are not supported with " <<
+            "--format html, and are rendered as text; further occurrences " <<
+            "are not reported");
+      }
+    }
+  }
+
+  /* relative URL of the top of the site */
+  std::string u = url(md);
+  std::string base;
+  for (char c : u) {
+    if (c == '/') {
+      base += "../";
+    }
+  }
+  std::string home = base.empty() ? "./" : base;
+
+  std::string out;
+  out.reserve(content.size() + 2048);
+  out += "<!DOCTYPE html>\n";
+  out += "<html lang=\"en\">\n";
+  out += "<head>\n";
+  out += "<meta charset=\"utf-8\">\n";
+  out += "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">\n";
+  out += "<meta name=\"generator\" content=\"doxide\">\n";
+  out += "<title>";
+  if (!renderer.title().empty() && renderer.title() != site) {
+    out += renderer.title();
+    out += " - ";
+  }
+  escape(site, out);
+  out += "</title>\n";
+  out += "<link rel=\"stylesheet\" href=\"" + base + "doxide-assets/doxide.css\">\n";
+  if (search) {
+    out += "<link rel=\"stylesheet\" href=\"" + base + "doxide-search/search.css\">\n";
+  }
+  out += "</head>\n";
+  out += "<body>\n";
+  out += "<header class=\"md-header\"><div class=\"md-header__inner\">";
+  out += "<a class=\"md-header__title\" href=\"" + home + "\">";
+  escape(site, out);
+  out += "</a></div></header>\n";
+
+  /* breadcrumbs, one for each directory of the URL, all of which have
+   * pages in the layout of MarkdownGenerator */
+  if (!u.empty()) {
+    out += "<nav class=\"doxide-breadcrumbs\"><a href=\"" + home + "\">";
+    escape(site, out);
+    out += "</a>";
+    std::string up = base;
+    for (std::size_t from = 0, to = u.find('/'); to != std::string::npos;
+        from = to + 1, to = u.find('/', from)) {
+      up.erase(0, 3);
+      out += " › ";
+      if (to + 1 < u.size()) {
+        out += "<a href=\"" + (up.empty() ? std::string("./") : up) + "\">";
+        escape(u.substr(from, to - from), out);
+        out += "</a>";
+      } else {
+        escape(u.substr(from, to - from), out);
+      }
+    }
+    out += "</nav>\n";
+  }
+
+  out += "<main class=\"md-typeset\"><article>\n";
+  out += content;
+  out += "</article></main>\n";
+  out += "<footer class=\"doxide-footer\">Made with ";
+  out += "<a href=\"https://doxide.org\" target=\"_blank\" rel=\"noopener\">Doxide</a>";
+  out += "</footer>\n";
+  out += "<script src=\"https://cdn.jsdelivr.net/npm/tablesort@5.3.0/src/tablesort.min.js\"></script>\n";
+  out += "<script src=\"https://cdn.jsdelivr.net/npm/tablesort@5.3.0/src/sorts/tablesort.number.js\"></script>\n";
+  out += "<script src=\"" + base + "doxide-assets/doxide.js\"></script>\n";
+  if (content.find("class=\"arithmatex\"") != std::string::npos) {
+    out += "<script src=\"https://cdn.jsdelivr.net/npm/mathjax@3/es5/tex-mml-chtml.js\"></script>\n";
+  }
+  if (search) {
+    out += "<script src=\"" + base + "doxide-search/search.js\"></script>\n";
+  }
+  out += "</body>\n";
+  out += "</html>\n";
+  return out;
+}
+
+std::vector<std::pair<std::filesystem::path,std::string_view>>
+    HTMLGenerator::assets() const {
+  return {
+    {output / "doxide-assets" / "doxide.css", html_css},
+    {output / "doxide-assets" / "doxide.js", html_js}
+  };
+}
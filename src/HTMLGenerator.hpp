@@ -0,0 +1,93 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * HTML generator. Converts the Markdown pages of MarkdownGenerator into
+ * finished HTML pages, as an alternative to building the site with MkDocs.
+ *
+ * @ingroup developer
+ *
+ * Each page `a/index.md` becomes `a/index.html`, and each other page `a/T.md`
+ * becomes `a/T/index.html`, so that pages have the same URLs as with MkDocs.
+ * Links between pages are rewritten accordingly. Pages share a style sheet
+ * and script, given by assets().
+ *
+ * Pages are rendered with HTMLRenderer, which supports the Markdown of
+ * MarkdownGenerator and the common Markdown of documentation comments, but
+ * not all of that supported by MkDocs. Constructs that it does not support
+ * are rendered as text, with a warning on the first occurrence of each.
+ */
+class HTMLGenerator {
+public:
+  /**
+   * Constructor.
+   *
+   * @param output Output directory.
+   */
+  HTMLGenerator(const std::filesystem::path& output);
+
+  /**
+   * File name of the HTML page for a Markdown page.
+   *
+   * @param md File name of the Markdown page.
+   */
+  std::filesystem::path file(const std::filesystem::path& md) const;
+
+  /**
+   * Render a page.
+   *
+   * @param md File name of the Markdown page.
+   * @param markdown Contents of the Markdown page.
+   * @param site Title of the site.
+   * @param search Include the search index of Doxide?
+   *
+   * @return Contents of the HTML page.
+   */
+  std::string page(const std::filesystem::path& md,
+      const std::string_view& markdown, const std::string& site,
+      const bool search) const;
+
+  /**
+   * Static assets shared by all pages, as pairs of file name and contents.
+   */
+  std::vector<std::pair<std::filesystem::path,std::string_view>>
+      assets() const;
+
+private:
+  /**
+   * URL of the HTML page for a Markdown page, relative to the output
+   * directory, ending in a slash, or empty for the top page.
+   */
+  std::string url(const std::filesystem::path& md) const;
+
+  /**
+   * Rewrite the target of a link or image on a page.
+   *
+   * @param md File name of the Markdown page on which the link appears.
+   * @param target Target of the link.
+   */
+  std::string link(const std::filesystem::path& md,
+      const std::string_view& target) const;
+
+  /**
+   * Output directory.
+   */
+  std::filesystem::path output;
+
+  /**
+   * Unsupported constructs already warned about.
+   */
+  mutable std::set<std::string_view> warned;
+
+  /**
+   * Mutex for warned, as pages are rendered concurrently.
+   */
+  mutable std::mutex mutex;
+};
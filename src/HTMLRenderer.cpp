@@ -0,0 +1,1119 @@
+#include "HTMLRenderer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+/**
+ * Icons for shortcodes, e.g. `:material-package:`, as text. Icons not listed
+ * are omitted.
+ *
+ * @ingroup developer
+ */
+static const std::pair<std::string_view,std::string_view> icons[] = {
+  {"material-alert-circle-outline", "⚠"},
+  {"material-chart-pie", "◔"},
+  {"material-check-circle-outline", "✓"},
+  {"material-code-tags", "‹›"},
+  {"material-eye-outline", "◉"},
+  {"material-format-section", "§"},
+  {"material-keyboard-return", "↵"},
+  {"material-location-enter", "→"},
+  {"material-location-exit", "←"},
+  {"material-package", "▣"}
+};
+
+/**
+ * Is a line blank?
+ *
+ * @ingroup developer
+ */
+static bool is_blank(const std::string_view& line) {
+  return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+/**
+ * Indentation of a line, in columns, with tabs to multiples of four.
+ *
+ * @ingroup developer
+ */
+static std::size_t indentation(const std::string_view& line) {
+  std::size_t n = 0;
+  for (char c : line) {
+    if (c == ' ') {
+      ++n;
+    } else if (c == '\t') {
+      n += 4 - n % 4;
+    } else {
+      break;
+    }
+  }
+  return n;
+}
+
+/**
+ * Remove up to a number of columns of indentation from a line.
+ *
+ * @ingroup developer
+ */
+static std::string_view dedent(std::string_view line, const std::size_t n) {
+  std::size_t col = 0;
+  while (col < n && !line.empty() && (line[0] == ' ' || line[0] == '\t')) {
+    col += (line[0] == '\t') ? 4 - col % 4 : 1;
+    line.remove_prefix(1);
+  }
+  return line;
+}
+
+/**
+ * Remove whitespace from both ends of a string.
+ *
+ * @ingroup developer
+ */
+static std::string_view trim(const std::string_view& str) {
+  auto first = str.find_first_not_of(" \t\r");
+  auto last = str.find_last_not_of(" \t\r");
+  return first == std::string_view::npos ? std::string_view() :
+      str.substr(first, last - first + 1);
+}
+
+/**
+ * Append a string to HTML output, escaping special characters.
+ *
+ * @ingroup developer
+ */
+static void escape(const std::string_view& str, std::string& out) {
+  for (char c : str) {
+    switch (c) {
+    case '&': out += "&amp;"; break;
+    case '<': out += "&lt;"; break;
+    case '>': out += "&gt;"; break;
+    case '"': out += "&quot;"; break;
+    default: out += c;
+    }
+  }
+}
+
+/**
+ * Is a line the opening of a fenced code block? If so, gets the fence
+ * character, its length, and the info string.
+ *
+ * @ingroup developer
+ */
+static bool is_fence(const std::string_view& line, char& c, std::size_t& len,
+    std::string_view& info) {
+  if (indentation(line) > 3) {
+    return false;
+  }
+  std::string_view l = dedent(line, 3);
+  if (l.empty() || (l[0] != '`' && l[0] != '~')) {
+    return false;
+  }
+  c = l[0];
+  len = l.find_first_not_of(c);
+  if (len == std::string_view::npos) {
+    len = l.size();
+  }
+  info = trim(l.substr(len));
+  return len >= 3 && (c != '`' || info.find('`') == std::string_view::npos);
+}
+
+/**
+ * Is a line the closing of a fenced code block?
+ *
+ * @ingroup developer
+ */
+static bool is_fence_end(const std::string_view& line, const char c,
+    const std::size_t len) {
+  std::string_view l = trim(line);
+  return indentation(line) <= 3 && l.size() >= len &&
+      l.find_first_not_of(c) == std::string_view::npos;
+}
+
+/**
+ * Is a line an ATX heading? If so, gets its level and text.
+ *
+ * @ingroup developer
+ */
+static bool is_heading(const std::string_view& line, int& level,
+    std::string_view& text) {
+  if (indentation(line) > 3) {
+    return false;
+  }
+  std::string_view l = trim(line);
+  std::size_t n = l.find_first_not_of('#');
+  if (n == 0 || n > 6 || (n != std::string_view::npos && l[n] != ' ' &&
+      l[n] != '\t')) {
+    return false;
+  }
+  level = int(std::min(n, l.size()));
+  text = n == std::string_view::npos ? std::string_view() : trim(l.substr(n));
+
+  /* optional closing sequence */
+  std::size_t end = text.find_last_not_of('#');
+  if (end == std::string_view::npos) {
+    text = std::string_view();
+  } else if (end + 1 < text.size() && (text[end] == ' ' ||
+      text[end] == '\t')) {
+    text = trim(text.substr(0, end));
+  }
+  return true;
+}
+
+/**
+ * Is a line a horizontal rule?
+ *
+ * @ingroup developer
+ */
+static bool is_hr(const std::string_view& line) {
+  if (indentation(line) > 3) {
+    return false;
+  }
+  std::string_view l = trim(line);
+  if (l.empty() || (l[0] != '-' && l[0] != '*' && l[0] != '_')) {
+    return false;
+  }
+  int count = 0;
+  for (char c : l) {
+    if (c == l[0]) {
+      ++count;
+    } else if (c != ' ' && c != '\t') {
+      return false;
+    }
+  }
+  return count >= 3;
+}
+
+/**
+ * Is a line the start of an admonition, e.g. `!!! note "Title"`, or of
+ * collapsible details, e.g. `??? note`?
+ *
+ * @ingroup developer
+ */
+static bool is_admonition(const std::string_view& line) {
+  return indentation(line) == 0 && (line.starts_with("!!! ") ||
+      line.starts_with("??? ") || line.starts_with("???+ "));
+}
+
+/**
+ * Is a line the start of a raw HTML block?
+ *
+ * @ingroup developer
+ */
+static bool is_html(const std::string_view& line) {
+  if (indentation(line) > 3) {
+    return false;
+  }
+  std::string_view l = trim(line);
+  return l.size() >= 2 && l[0] == '<' && (std::isalpha(
+      static_cast<unsigned char>(l[1])) || l[1] == '/' || l[1] == '!');
+}
+
+/**
+ * Is a line a list item? If so, gets whether it is ordered, its start
+ * number, and the column at which its content begins.
+ *
+ * @ingroup developer
+ */
+static bool is_item(const std::string_view& line, bool& ordered, int& start,
+    std::size_t& content) {
+  std::size_t ind = indentation(line);
+  std::string_view l = dedent(line, ind);
+  std::size_t marker = 0;
+  if (!l.empty() && (l[0] == '-' || l[0] == '*' || l[0] == '+')) {
+    ordered = false;
+    marker = 1;
+  } else {
+    std::size_t digits = 0;
+    while (digits < l.size() && digits < 9 && std::isdigit(
+        static_cast<unsigned char>(l[digits]))) {
+      ++digits;
+    }
+    if (digits == 0 || digits >= l.size() || (l[digits] != '.' &&
+        l[digits] != ')')) {
+      return false;
+    }
+    ordered = true;
+    start = std::stoi(std::string(l.substr(0, digits)));
+    marker = digits + 1;
+  }
+  if (marker < l.size() && l[marker] != ' ' && l[marker] != '\t') {
+    return false;
+  }
+  std::size_t spaces = indentation(l.substr(marker));
+  if (marker == l.size() || spaces > 4 || is_blank(l.substr(marker))) {
+    spaces = 1;
+  }
+  content = ind + marker + spaces;
+  return true;
+}
+
+/**
+ * Is a line the start of a definition in a definition list, i.e. a colon
+ * followed by whitespace?
+ *
+ * @ingroup developer
+ */
+static bool is_definition(const std::string_view& line) {
+  return indentation(line) <= 3 && [](std::string_view l) {
+    return l.size() >= 2 && l[0] == ':' && (l[1] == ' ' || l[1] == '\t');
+  }(dedent(line, 3));
+}
+
+/**
+ * Is a line a link reference definition, e.g. `[id]: https://...`, or a
+ * footnote definition, e.g. `[^1]: ...`?
+ *
+ * @ingroup developer
+ */
+static bool is_reference(const std::string_view& line) {
+  if (indentation(line) > 3) {
+    return false;
+  }
+  std::string_view l = trim(line);
+  std::size_t close = l.find("]:");
+  return l.starts_with('[') && close != std::string_view::npos && close > 1 &&
+      l.substr(0, close).find(']') == std::string_view::npos;
+}
+
+/**
+ * Is a line an underline of a setext heading, i.e. only `=` or `-`
+ * characters?
+ *
+ * @ingroup developer
+ */
+static bool is_underline(const std::string_view& line) {
+  std::string_view l = trim(line);
+  return indentation(line) <= 3 && !l.empty() &&
+      (l.find_first_not_of('=') == std::string_view::npos ||
+      l.find_first_not_of('-') == std::string_view::npos);
+}
+
+/**
+ * Split a table row into cells.
+ *
+ * @ingroup developer
+ */
+static std::vector<std::string_view> cells(std::string_view row) {
+  row = trim(row);
+  if (row.starts_with('|')) {
+    row.remove_prefix(1);
+  }
+  if (row.ends_with('|') && !row.ends_with("\\|")) {
+    row.remove_suffix(1);
+  }
+  std::vector<std::string_view> result;
+  std::size_t from = 0;
+  bool code = false;
+  for (std::size_t i = 0; i < row.size(); ++i) {
+    if (row[i] == '\\') {
+      ++i;
+    } else if (row[i] == '`') {
+      code = !code;
+    } else if (row[i] == '|' && !code) {
+      result.push_back(trim(row.substr(from, i - from)));
+      from = i + 1;
+    }
+  }
+  result.push_back(trim(row.substr(from)));
+  return result;
+}
+
+/**
+ * Is a line the delimiter row of a table, e.g. `| --- | ---: |`?
+ *
+ * @ingroup developer
+ */
+static bool is_delimiter_row(const std::string_view& line) {
+  if (line.find('-') == std::string_view::npos) {
+    return false;
+  }
+  for (auto cell : cells(line)) {
+    if (cell.empty() || cell.find_first_not_of(":-") != std::string_view::npos ||
+        cell.find('-') == std::string_view::npos) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HTMLRenderer::HTMLRenderer(const link_type& link) :
+    link(link) {
+  //
+}
+
+std::string HTMLRenderer::render(const std::string_view& markdown) {
+  std::vector<std::string_view> lines;
+  std::size_t from = 0;
+  while (from < markdown.size()) {
+    std::size_t to = markdown.find('\n', from);
+    if (to == std::string_view::npos) {
+      to = markdown.size();
+    }
+    std::string_view line = markdown.substr(from, to - from);
+    if (line.ends_with('\r')) {
+      line.remove_suffix(1);
+    }
+    lines.push_back(line);
+    from = to + 1;
+  }
+  std::string out;
+  out.reserve(markdown.size() + markdown.size()/4);
+  blocks(lines, out);
+  return out;
+}
+
+void HTMLRenderer::blocks(const std::vector<std::string_view>& lines,
+    std::string& out) {
+  const std::size_t n = lines.size();
+  std::size_t i = 0;
+  char fence_char;
+  std::size_t fence_len;
+  std::string_view info, text;
+  int level;
+  bool ordered;
+  int start = 1;
+  std::size_t content = 0;
+
+  /* does a line interrupt a paragraph? */
+  auto interrupts = [&](const std::string_view& line) {
+    char c;
+    std::size_t len;
+    std::string_view s;
+    int l;
+    return is_blank(line) || is_fence(line, c, len, s) ||
+        is_heading(line, l, s) || is_admonition(line) || is_hr(line) ||
+        trim(line).starts_with("$$") || trim(line).starts_with('>');
+  };
+
+  while (i < n) {
+    std::string_view line = lines[i];
+    if (is_blank(line)) {
+      ++i;
+    } else if (is_fence(line, fence_char, fence_len, info)) {
+      /* fenced code; content is dedented by the indentation of the fence */
+      std::size_t ind = indentation(line);
+      std::vector<std::string_view> body;
+      for (++i; i < n && !is_fence_end(lines[i], fence_char, fence_len); ++i) {
+        body.push_back(dedent(lines[i], ind));
+      }
+      ++i;  // closing fence
+      code(info, body, out);
+    } else if (is_heading(line, level, text)) {
+      std::string html;
+      inlines(text, html);
+      out += "<h" + std::to_string(level) + " id=\"" + slug(html) + "\">";
+      out += html;
+      out += "</h" + std::to_string(level) + ">\n";
+      if (level == 1 && first_title.empty()) {
+        /* text only, for the page title */
+        bool tag = false;
+        for (char c : html) {
+          if (c == '<') {
+            tag = true;
+          } else if (c == '>') {
+            tag = false;
+          } else if (!tag) {
+            first_title += c;
+          }
+        }
+      }
+      ++i;
+    } else if (is_hr(line)) {
+      out += "<hr>\n";
+      ++i;
+    } else if (is_admonition(line)) {
+      /* admonition, or collapsible details, with content indented by four
+       * spaces */
+      bool details = line.starts_with("???");
+      bool open = line.starts_with("???+");
+      std::string_view rest = trim(line.substr(line.find(' ')));
+      std::string_view kind = rest.substr(0, rest.find_first_of(" \t"));
+      std::string_view title;
+      bool has_title = false;
+      std::size_t quote = rest.find('"');
+      if (quote != std::string_view::npos && rest.ends_with('"') &&
+          rest.size() > quote + 1) {
+        title = rest.substr(quote + 1, rest.size() - quote - 2);
+        has_title = true;
+      }
+      std::vector<std::string_view> body;
+      for (++i; i < n && (is_blank(lines[i]) || indentation(lines[i]) >= 4);
+          ++i) {
+        body.push_back(dedent(lines[i], 4));
+      }
+      while (!body.empty() && is_blank(body.back())) {
+        body.pop_back();
+        --i;
+      }
+
+      std::string cls;
+      escape(kind, cls);
+      std::string heading;
+      if (has_title) {
+        inlines(title, heading);
+      } else {
+        escape(kind, heading);
+        if (!heading.empty()) {
+          heading[0] = std::toupper(static_cast<unsigned char>(heading[0]));
+        }
+      }
+      if (details) {
+        out += "<details class=\"" + cls + (open ? "\" open>\n" : "\">\n");
+        out += "<summary>" + heading + "</summary>\n";
+        blocks(body, out);
+        out += "</details>\n";
+      } else {
+        out += "<div class=\"admonition " + cls + "\">\n";
+        if (!has_title || !title.empty()) {
+          out += "<p class=\"admonition-title\">" + heading + "</p>\n";
+        }
+        blocks(body, out);
+        out += "</div>\n";
+      }
+    } else if (trim(line).starts_with("$$")) {
+      /* display math, possibly over several lines */
+      std::string math;
+      std::string_view l = trim(line).substr(2);
+      for (;;) {
+        std::size_t end = l.find("$$");
+        if (end != std::string_view::npos) {
+          math += l.substr(0, end);
+          break;
+        }
+        math += l;
+        if (++i == n) {
+          break;
+        }
+        math += '\n';
+        l = lines[i];
+      }
+      ++i;
+      out += "<div class=\"arithmatex\">\\[";
+      escape(math, out);
+      out += "\\]</div>\n";
+    } else if (is_html(line)) {
+      /* raw HTML, up to the next blank line */
+      for (; i < n && !is_blank(lines[i]); ++i) {
+        out += lines[i];
+        out += '\n';
+      }
+    } else if (trim(line).starts_with('>')) {
+      /* block quote, with lazy continuation lines */
+      std::vector<std::string_view> body;
+      for (; i < n && !is_blank(lines[i]); ++i) {
+        std::string_view l = trim(lines[i]);
+        if (l.starts_with('>')) {
+          l.remove_prefix(1);
+          if (l.starts_with(' ')) {
+            l.remove_prefix(1);
+          }
+        }
+        body.push_back(l);
+      }
+      out += "<blockquote>\n";
+      blocks(body, out);
+      out += "</blockquote>\n";
+    } else if (i + 1 < n && line.find('|') != std::string_view::npos &&
+        is_delimiter_row(lines[i + 1])) {
+      std::vector<std::string_view> rows;
+      for (; i < n && !is_blank(lines[i]) &&
+          lines[i].find('|') != std::string_view::npos; ++i) {
+        rows.push_back(lines[i]);
+      }
+      table(rows, out);
+    } else if (is_item(line, ordered, start, content)) {
+      /* list; items are tight unless separated by blank lines */
+      std::size_t ind = indentation(line);
+      std::vector<std::vector<std::string_view>> items;
+      bool loose = false;
+      bool first_ordered = ordered;
+      int first_start = start;
+      while (i < n) {
+        bool o;
+        int s;
+        std::size_t c, c2;
+        if (!is_item(lines[i], o, s, c) || o != first_ordered ||
+            indentation(lines[i]) != ind) {
+          break;
+        }
+        auto& item = items.emplace_back();
+        std::string_view first = dedent(lines[i], ind);
+        std::size_t marker = first.find_first_of(" \t");
+        item.push_back(marker == std::string_view::npos ? std::string_view() :
+            dedent(first.substr(marker), c - ind - marker));
+        for (++i; i < n; ++i) {
+          std::string_view l = lines[i];
+          if (is_blank(l)) {
+            /* continues the item only if followed by indented content */
+            std::size_t k = i;
+            while (k < n && is_blank(lines[k])) {
+              ++k;
+            }
+            if (k < n && indentation(lines[k]) >= c) {
+              for (; i < k; ++i) {
+                item.push_back(std::string_view());
+              }
+              --i;
+              loose = true;
+            } else {
+              if (k < n && is_item(lines[k], o, s, c) &&
+                  indentation(lines[k]) == ind) {
+                loose = true;
+                i = k;
+              }
+              break;
+            }
+          } else if (indentation(l) >= c) {
+            item.push_back(dedent(l, c));
+          } else if (is_item(l, o, s, c2) || interrupts(l) ||
+              is_definition(l)) {
+            break;
+          } else {
+            /* lazy continuation */
+            item.push_back(trim(l));
+          }
+        }
+      }
+      if (first_ordered) {
+        out += first_start == 1 ? "<ol>\n" :
+            "<ol start=\"" + std::to_string(first_start) + "\">\n";
+      } else {
+        out += "<ul>\n";
+      }
+      for (auto& item : items) {
+        std::string html;
+        blocks(item, html);
+        if (!loose && html.starts_with("<p>")) {
+          /* tight list, so no paragraph around the first line of text */
+          std::size_t end = html.find("</p>\n");
+          html.erase(end, 4);
+          html.erase(0, 3);
+          if (html.ends_with('\n')) {
+            html.pop_back();
+          }
+        }
+        out += "<li>" + html + "</li>\n";
+      }
+      out += first_ordered ? "</ol>\n" : "</ul>\n";
+    } else {
+      /* paragraph, unless its last line is followed by a definition, in
+       * which case that line is the term of a definition list */
+      if (indentation(line) >= 4) {
+        note("indented code blocks");
+      } else if (line.starts_with("=== ")) {
+        note("content tabs");
+      } else if (is_reference(line)) {
+        note("link reference and footnote definitions");
+      }
+      std::size_t j = i + 1;
+      while (j < n && !interrupts(lines[j]) && !is_definition(lines[j]) &&
+          !is_html(lines[j]) && !(is_item(lines[j], ordered, start, content) &&
+          !ordered)) {
+        ++j;
+      }
+      if (j < n && is_underline(lines[j]) && !is_blank(lines[j - 1])) {
+        note("setext headings");
+      } else {
+        for (std::size_t k = i + 1; k < j; ++k) {
+          if (is_underline(lines[k])) {
+            note("setext headings");
+          }
+        }
+      }
+      if (j < n && is_definition(lines[j])) {
+        if (j - 1 > i) {
+          std::string para;
+          for (std::size_t k = i; k < j - 1; ++k) {
+            para += trim(lines[k]);
+            para += '\n';
+          }
+          para.pop_back();
+          out += "<p>";
+          inlines(para, out);
+          out += "</p>\n";
+        }
+        out += "<dl>\n<dt>";
+        inlines(trim(lines[j - 1]), out);
+        out += "</dt>\n";
+        i = j;
+        while (i < n && is_definition(lines[i])) {
+          std::vector<std::string_view> body;
+          body.push_back(trim(dedent(lines[i], 3).substr(1)));
+          bool para = false;
+          for (++i; i < n; ++i) {
+            std::string_view l = lines[i];
+            if (is_blank(l)) {
+              std::size_t k = i;
+              while (k < n && is_blank(lines[k])) {
+                ++k;
+              }
+              if (k < n && indentation(lines[k]) >= 4) {
+                for (; i < k; ++i) {
+                  body.push_back(std::string_view());
+                }
+                --i;
+                para = true;
+              } else {
+                if (k < n && is_definition(lines[k])) {
+                  i = k;
+                }
+                break;
+              }
+            } else if (is_definition(l)) {
+              break;
+            } else if (indentation(l) >= 4) {
+              body.push_back(dedent(l, 4));
+            } else if (interrupts(l)) {
+              break;
+            } else {
+              body.push_back(trim(l));
+            }
+          }
+          std::string html;
+          blocks(body, html);
+          if (!para && html.starts_with("<p>") &&
+              html.find("<p>", 3) == std::string::npos) {
+            html.erase(html.find("</p>\n"), 4);
+            html.erase(0, 3);
+            if (html.ends_with('\n')) {
+              html.pop_back();
+            }
+          }
+          out += "<dd>" + html + "</dd>\n";
+        }
+        out += "</dl>\n";
+      } else {
+        std::string para;
+        for (std::size_t k = i; k < j; ++k) {
+          para += trim(lines[k]);
+          para += '\n';
+        }
+        para.pop_back();
+        out += "<p>";
+        inlines(para, out);
+        out += "</p>\n";
+        i = j;
+      }
+    }
+  }
+}
+
+void HTMLRenderer::inlines(const std::string_view& str, std::string& out) {
+  const std::size_t n = str.size();
+  std::size_t i = 0;
+  while (i < n) {
+    /* copy plain text up to the next special character in one go */
+    std::size_t j = str.find_first_of("\\`$![*_:<>&\"", i);
+    if (j == std::string_view::npos) {
+      j = n;
+    }
+    out += str.substr(i, j - i);
+    i = j;
+    if (i == n) {
+      break;
+    }
+
+    char c = str[i];
+    if (c == '\\') {
+      if (i + 1 < n && std::ispunct(static_cast<unsigned char>(str[i + 1]))) {
+        escape(str.substr(i + 1, 1), out);
+        i += 2;
+      } else {
+        out += '\\';
+        ++i;
+      }
+    } else if (c == '`') {
+      /* code span, closed by a run of backticks of the same length */
+      std::size_t k = str.find_first_not_of('`', i);
+      if (k == std::string_view::npos) {
+        k = n;
+      }
+      std::size_t run = k - i;
+      std::size_t end = k;
+      for (;;) {
+        end = str.find('`', end);
+        if (end == std::string_view::npos) {
+          break;
+        }
+        std::size_t e = str.find_first_not_of('`', end);
+        if (e == std::string_view::npos) {
+          e = n;
+        }
+        if (e - end == run) {
+          break;
+        }
+        end = e;
+      }
+      if (end == std::string_view::npos) {
+        out += str.substr(i, run);
+        i = k;
+      } else {
+        std::string content(str.substr(k, end - k));
+        std::replace(content.begin(), content.end(), '\n', ' ');
+        if (content.size() >= 2 && content.front() == ' ' &&
+            content.back() == ' ' &&
+            content.find_first_not_of(' ') != std::string::npos) {
+          content = content.substr(1, content.size() - 2);
+        }
+        out += "<code>";
+        escape(content, out);
+        out += "</code>";
+        i = end + run;
+      }
+    } else if (c == '$') {
+      /* math, as $...$ or $$...$$ */
+      bool display = i + 1 < n && str[i + 1] == '$';
+      std::size_t from = i + (display ? 2 : 1);
+      std::size_t end = std::string_view::npos;
+      if (display) {
+        end = str.find("$$", from);
+      } else if (from < n && str[from] != ' ') {
+        for (std::size_t k = from; k < n; ++k) {
+          if (str[k] == '\\') {
+            ++k;
+          } else if (str[k] == '$') {
+            if (str[k - 1] != ' ') {
+              end = k;
+            }
+            break;
+          }
+        }
+      }
+      if (end == std::string_view::npos || end == from) {
+        out += '$';
+        ++i;
+      } else {
+        out += display ? "<span class=\"arithmatex\">\\[" :
+            "<span class=\"arithmatex\">\\(";
+        escape(str.substr(from, end - from), out);
+        out += display ? "\\]</span>" : "\\)</span>";
+        i = end + (display ? 2 : 1);
+      }
+    } else if (c == '[' || (c == '!' && i + 1 < n && str[i + 1] == '[')) {
+      /* link or image, as [text](target "title") */
+      bool image = c == '!';
+      std::size_t open = i + (image ? 1 : 0);
+      std::size_t close = std::string_view::npos;
+      int depth = 0;
+      for (std::size_t k = open; k < n; ++k) {
+        if (str[k] == '\\') {
+          ++k;
+        } else if (str[k] == '[') {
+          ++depth;
+        } else if (str[k] == ']' && --depth == 0) {
+          close = k;
+          break;
+        }
+      }
+      std::size_t end = std::string_view::npos;
+      if (close != std::string_view::npos && close + 1 < n &&
+          str[close + 1] == '(') {
+        depth = 0;
+        for (std::size_t k = close + 1; k < n; ++k) {
+          if (str[k] == '(') {
+            ++depth;
+          } else if (str[k] == ')' && --depth == 0) {
+            end = k;
+            break;
+          }
+        }
+      }
+      if (end == std::string_view::npos) {
+        if (close != std::string_view::npos && (i == 0 || !std::isalnum(
+            static_cast<unsigned char>(str[i - 1]))) && (str[open + 1] == '^' ||
+            (close + 1 < n && str[close + 1] == '['))) {
+          note("reference links and footnotes");
+        }
+        out += c;
+        ++i;
+      } else {
+        if (end + 1 < n && str[end + 1] == '{') {
+          note("attribute lists");
+        }
+        std::string_view text = str.substr(open + 1, close - open - 1);
+        std::string_view dest = trim(str.substr(close + 2, end - close - 2));
+        std::string_view title;
+        std::size_t space = dest.find_first_of(" \t");
+        if (space != std::string_view::npos) {
+          title = trim(dest.substr(space));
+          dest = dest.substr(0, space);
+          if (title.size() >= 2 && (title[0] == '"' || title[0] == '\'')) {
+            title = title.substr(1, title.size() - 2);
+          }
+        }
+        if (dest.size() >= 2 && dest.front() == '<' && dest.back() == '>') {
+          dest = dest.substr(1, dest.size() - 2);
+        }
+        std::string href = link(dest);
+        if (image) {
+          out += "<img src=\"";
+          escape(href, out);
+          out += "\" alt=\"";
+          escape(text, out);
+          out += '"';
+          if (!title.empty()) {
+            out += " title=\"";
+            escape(title, out);
+            out += '"';
+          }
+          out += '>';
+        } else {
+          out += "<a href=\"";
+          escape(href, out);
+          out += '"';
+          if (!title.empty()) {
+            out += " title=\"";
+            escape(title, out);
+            out += '"';
+          }
+          out += '>';
+          inlines(text, out);
+          out += "</a>";
+        }
+        i = end + 1;
+      }
+    } else if (c == '*' || c == '_') {
+      /* emphasis; underscores only at word boundaries, as they are common
+       * in identifiers */
+      auto word = [](char ch) {
+        return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_';
+      };
+      std::size_t k = str.find_first_not_of(c, i);
+      if (k == std::string_view::npos) {
+        k = n;
+      }
+      std::size_t run = std::min<std::size_t>(k - i, 2);
+      std::size_t end = std::string_view::npos;
+      bool left = k < n && str[k] != ' ' && str[k] != '\n' &&
+          (c == '*' || i == 0 || !word(str[i - 1]));
+      if (left) {
+        std::string_view delim = str.substr(i, run);
+        for (std::size_t e = str.find(delim, k); e != std::string_view::npos;
+            e = str.find(delim, e + 1)) {
+          bool right = str[e - 1] != ' ' && str[e - 1] != '\n' &&
+              (c == '*' || e + run == n || !word(str[e + run]));
+          if (right && e > k) {
+            end = e;
+            break;
+          }
+        }
+      }
+      if (end == std::string_view::npos) {
+        out += str.substr(i, k - i);
+        i = k;
+      } else {
+        const char* tag = run == 2 ? "strong" : "em";
+        out += "<";
+        out += tag;
+        out += ">";
+        inlines(str.substr(i + run, end - i - run), out);
+        out += "</";
+        out += tag;
+        out += ">";
+        i = end + run;
+      }
+    } else if (c == ':') {
+      /* icon shortcode, e.g. :material-package: */
+      std::size_t k = i + 1;
+      while (k < n && (std::islower(static_cast<unsigned char>(str[k])) ||
+          std::isdigit(static_cast<unsigned char>(str[k])) || str[k] == '-' ||
+          str[k] == '_')) {
+        ++k;
+      }
+      std::string_view name = str.substr(i + 1, k - i - 1);
+      if (k < n && str[k] == ':' && (name.starts_with("material-") ||
+          name.starts_with("octicons-") || name.starts_with("fontawesome-") ||
+          name.starts_with("simple-"))) {
+        for (auto& [key, glyph] : icons) {
+          if (key == name) {
+            out += "<span class=\"doxide-icon\">";
+            out += glyph;
+            out += "</span>";
+            break;
+          }
+        }
+        i = k + 1;
+      } else {
+        out += ':';
+        ++i;
+      }
+    } else if (c == '<') {
+      /* raw HTML tag or autolink, otherwise a literal */
+      std::size_t end = str.find('>', i);
+      std::size_t nl = str.find('\n', i);
+      bool tag = end != std::string_view::npos && end < nl && i + 1 < n &&
+          (std::isalpha(static_cast<unsigned char>(str[i + 1])) ||
+          str[i + 1] == '/' || str[i + 1] == '!');
+      std::string_view inner = tag ? str.substr(i + 1, end - i - 1) :
+          std::string_view();
+      if (tag && (inner.starts_with("http://") ||
+          inner.starts_with("https://")) &&
+          inner.find(' ') == std::string_view::npos) {
+        out += "<a href=\"";
+        escape(inner, out);
+        out += "\">";
+        escape(inner, out);
+        out += "</a>";
+        i = end + 1;
+      } else if (tag) {
+        out += str.substr(i, end - i + 1);
+        i = end + 1;
+      } else {
+        out += "&lt;";
+        ++i;
+      }
+    } else if (c == '&') {
+      /* entity, otherwise a literal */
+      std::size_t k = i + 1;
+      if (k < n && str[k] == '#') {
+        ++k;
+      }
+      std::size_t from = k;
+      while (k < n && std::isalnum(static_cast<unsigned char>(str[k]))) {
+        ++k;
+      }
+      if (k > from && k < n && str[k] == ';') {
+        out += str.substr(i, k - i + 1);
+        i = k + 1;
+      } else {
+        out += "&amp;";
+        ++i;
+      }
+    } else if (c == '>') {
+      out += "&gt;";
+      ++i;
+    } else if (c == '"') {
+      out += "&quot;";
+      ++i;
+    } else {
+      /* '!' not followed by '[' */
+      out += c;
+      ++i;
+    }
+  }
+}
+
+void HTMLRenderer::code(const std::string_view& info,
+    const std::vector<std::string_view>& lines, std::string& out) {
+  std::string_view lang = info.substr(0, info.find_first_of(" \t{"));
+  if (lang.starts_with('.')) {
+    lang.remove_prefix(1);
+  }
+  bool linenums = info.find("linenums=") != std::string_view::npos;
+
+  std::string code;
+  for (auto& line : lines) {
+    escape(line, code);
+    code += '\n';
+  }
+
+  out += "<div class=\"highlight\">";
+  if (linenums) {
+    /* as Pygments does, a table with one cell of line numbers, each in its
+     * own <span> after an initial empty one, then one cell of code */
+    out += "<table class=\"highlighttable\"><tr><td class=\"linenos\">";
+    out += "<div class=\"linenodiv\"><pre><span></span>";
+    for (std::size_t k = 1; k <= lines.size(); ++k) {
+      if (k > 1) {
+        out += '\n';
+      }
+      out += "<span class=\"normal\">" + std::to_string(k) + "</span>";
+    }
+    out += "</pre></div></td><td class=\"code\"><div><pre><span></span>";
+  } else {
+    out += "<pre>";
+  }
+  out += "<code";
+  if (!lang.empty()) {
+    out += " class=\"language-";
+    escape(lang, out);
+    out += '"';
+  }
+  out += '>';
+  out += code;
+  out += "</code></pre>";
+  if (linenums) {
+    out += "</div></td></tr></table>";
+  }
+  out += "</div>\n";
+}
+
+void HTMLRenderer::table(const std::vector<std::string_view>& lines,
+    std::string& out) {
+  std::vector<std::string> align;
+  for (auto cell : cells(lines[1])) {
+    bool l = cell.starts_with(':'), r = cell.ends_with(':');
+    align.push_back(l && r ? " style=\"text-align: center;\"" :
+        r ? " style=\"text-align: right;\"" :
+        l ? " style=\"text-align: left;\"" : "");
+  }
+  auto row = [&](const std::string_view& line, const char* tag) {
+    auto cs = cells(line);
+    out += "<tr>\n";
+    for (std::size_t k = 0; k < align.size(); ++k) {
+      out += "<";
+      out += tag;
+      out += align[k];
+      out += ">";
+      if (k < cs.size()) {
+        inlines(cs[k], out);
+      }
+      out += "</";
+      out += tag;
+      out += ">\n";
+    }
+    out += "</tr>\n";
+  };
+
+  out += "<table>\n<thead>\n";
+  row(lines[0], "th");
+  out += "</thead>\n<tbody>\n";
+  for (std::size_t k = 2; k < lines.size(); ++k) {
+    row(lines[k], "td");
+  }
+  out += "</tbody>\n</table>\n";
+}
+
+std::string HTMLRenderer::slug(const std::string_view& html) {
+  /* text only, lowercase, keeping letters, digits and underscores, with
+   * runs of spaces and hyphens replaced by a single hyphen */
+  std::string s;
+  bool tag = false, entity = false, hyphen = false;
+  for (char c : html) {
+    if (c == '<') {
+      tag = true;
+    } else if (tag) {
+      tag = c != '>';
+    } else if (c == '&') {
+      entity = true;
+    } else if (entity) {
+      entity = c != ';';
+    } else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+      if (hyphen && !s.empty()) {
+        s += '-';
+      }
+      hyphen = false;
+      s += std::tolower(static_cast<unsigned char>(c));
+    } else if (c == ' ' || c == '-' || c == '\t') {
+      hyphen = true;
+    }
+  }
+  if (s.empty()) {
+    s = "section";
+  }
+
+  /* make unique within the page, as MkDocs does */
+  int count = slugs[s]++;
+  if (count > 0) {
+    s += '_' + std::to_string(count);
+  }
+  return s;
+}
+
+void HTMLRenderer::note(const std::string_view& construct) {
+  if (std::find(constructs.begin(), constructs.end(), construct) ==
+      constructs.end()) {
+    constructs.push_back(construct);
+  }
+}
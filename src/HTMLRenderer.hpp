@@ -0,0 +1,123 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Renderer of Markdown as HTML.
+ *
+ * @ingroup developer
+ *
+ * Supports the Markdown produced by MarkdownGenerator, including from
+ * documentation comments: headings, paragraphs, lists, tables, definition
+ * lists, admonitions, fenced code (with line numbers), block quotes,
+ * horizontal rules, raw HTML, math, emphasis, code spans, links, images and
+ * icon shortcodes. This is enough to render pages without a Markdown
+ * processor, but is not a complete implementation of any Markdown dialect.
+ * Constructs that documentation comments may use, but that are not
+ * supported, are rendered as text, and reported by unsupported().
+ */
+class HTMLRenderer {
+public:
+  /**
+   * Function that rewrites the target of a link or image.
+   */
+  using link_type = std::function<std::string(const std::string_view&)>;
+
+  /**
+   * Constructor.
+   *
+   * @param link Function that rewrites the target of each link and image.
+   */
+  HTMLRenderer(const link_type& link);
+
+  /**
+   * Render Markdown as HTML.
+   *
+   * @param markdown Markdown.
+   *
+   * @return HTML.
+   */
+  std::string render(const std::string_view& markdown);
+
+  /**
+   * Text of the first level-one heading rendered, with tags removed, or
+   * empty if there is none.
+   */
+  const std::string& title() const {
+    return first_title;
+  }
+
+  /**
+   * Names of the constructs encountered but not supported, e.g. `setext
+   * headings`, each once, in the order encountered.
+   */
+  const std::vector<std::string_view>& unsupported() const {
+    return constructs;
+  }
+
+private:
+  /**
+   * Render blocks.
+   */
+  void blocks(const std::vector<std::string_view>& lines, std::string& out);
+
+  /**
+   * Render inline content.
+   */
+  void inlines(const std::string_view& str, std::string& out);
+
+  /**
+   * Render a fenced code block.
+   *
+   * @param info Info string, e.g. `cpp linenums="1"`.
+   * @param lines Lines of code.
+   * @param out Output.
+   */
+  void code(const std::string_view& info,
+      const std::vector<std::string_view>& lines, std::string& out);
+
+  /**
+   * Render a table.
+   *
+   * @param lines Lines of the table, including the delimiter row.
+   * @param out Output.
+   */
+  void table(const std::vector<std::string_view>& lines, std::string& out);
+
+  /**
+   * Unique identifier for a heading, as for the table of contents of
+   * MkDocs.
+   */
+  std::string slug(const std::string_view& html);
+
+  /**
+   * Record an unsupported construct.
+   *
+   * @param construct Name of the construct.
+   */
+  void note(const std::string_view& construct);
+
+  /**
+   * Function that rewrites the target of a link or image.
+   */
+  link_type link;
+
+  /**
+   * Text of the first level-one heading.
+   */
+  std::string first_title;
+
+  /**
+   * Number of uses of each heading identifier so far.
+   */
+  std::unordered_map<std::string,int> slugs;
+
+  /**
+   * Unsupported constructs encountered.
+   */
+  std::vector<std::string_view> constructs;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+/**
+ * Syntax highlighting styles, recorded one per byte of source.
+ *
+ * @ingroup developer
+ *
+ * Each style is output as a `<span>` with the class that Pygments uses for
+ * the same kind of token (see highlight_class()), so that the stylesheets of
+ * existing themes apply to pre-highlighted source as to source highlighted
+ * by Pygments.
+ */
+enum class Highlight : char {
+  NONE,
+  COMMENT,
+  PREPROC,
+  PREPROC_FILE,
+  KEYWORD,
+  KEYWORD_CONSTANT,
+  KEYWORD_TYPE,
+  STRING,
+  STRING_CHAR,
+  STRING_ESCAPE,
+  NUMBER,
+  NAME_CLASS,
+  NAME_FUNCTION,
+  NAME_NAMESPACE
+};
+
+/**
+ * Number of syntax highlighting styles.
+ *
+ * @ingroup developer
+ */
+constexpr int HIGHLIGHT_COUNT = int(Highlight::NAME_NAMESPACE) + 1;
+
+/**
+ * Get the Pygments class of a syntax highlighting style, or an empty string
+ * for Highlight::NONE.
+ *
+ * @ingroup developer
+ */
+inline const char* highlight_class(const Highlight style) {
+  static const char* classes[HIGHLIGHT_COUNT] = {
+    "", "c", "cp", "cpf", "k", "kc", "kt", "s", "sc", "se", "m", "nc", "nf",
+    "nn"
+  };
+  int i = int(style);
+  return (0 <= i && i < HIGHLIGHT_COUNT) ? classes[i] : "";
+}
@@ -41,24 +41,19 @@ void JSONCounter::count(const std::filesystem::path& coverage, Entity& root) {
             warn("missing 'count' key in 'lines' element in " << file);
           } else {
             int line_number = std::stoi(line->value("line_number")) - 1;
-            int count = std::stoi(line->value("count"));
+            uint64_t count = std::stoull(line->value("count"));
             if (line_number < 0 || size_t(line_number) >= nlines) {
               warn("in " << file << ", " << path << ":" << line_number <<
                   " does not exist; ignoring, are source and coverage" <<
                   " files in sync?");
             } else if (count > 0) {
-              int& line_count = file->line_counts[line_number];
-              if (line_count == 0) {
+              if (file->line_counts.add(line_number, count)) {
                 /* line is included in report and first time seeing it
                  * covered, update aggregate counts for whole path */
                 for (auto e : es) {
                   ++e->lines_covered;
                 }
               }
-              if (line_count >= 0) {
-                /* line is included in report, update count */
-                line_count += count;
-              }
             }
           }
         }
@@ -0,0 +1,127 @@
+#include "JSONExporter.hpp"
+
+#include "SymbolTable.hpp"
+
+/**
+ * Version of the export schema.
+ *
+ * @ingroup developer
+ */
+static const int EXPORT_VERSION = 1;
+
+/**
+ * Names of entity types in the export schema, by EntityType.
+ *
+ * @ingroup developer
+ */
+static const char* export_types[] = {
+  "root",
+  "namespace",
+  "template",
+  "group",
+  "type",
+  "typedef",
+  "concept",
+  "variable",
+  "function",
+  "operator",
+  "enumerator",
+  "macro",
+  "dir",
+  "file"
+};
+
+void JSONExporter::generate(const Entity& root, std::ostream& out) {
+  BufferedWriter w(out);
+  w.write("{\"version\":");
+  w.write(EXPORT_VERSION);
+  w.write(",\"root\":");
+  generate(root, nullptr, w);
+  w.write("}\n");
+}
+
+void JSONExporter::generate(const Entity& entity, const Entity* group,
+    BufferedWriter& w) {
+  w.write("{\"type\":");
+  string(export_types[int(entity.type)], w);
+  w.write(",\"name\":");
+  string(entity.name.view(), w);
+  w.write(",\"title\":");
+  string(entity.title, w);
+  w.write(",\"decl\":");
+  if (entity.type == EntityType::FILE) {
+    /* the declaration of a file is its full contents; omit */
+    string("", w);
+  } else {
+    string(entity.decl, w);
+  }
+  w.write(",\"docs\":");
+  if (entity.docs.find(SymbolTable::MARKER_BEGIN) == std::string::npos) {
+    string(entity.docs, w);
+  } else {
+    /* there are no pages to link to, so cross-references take their
+     * unresolved form */
+    static const SymbolTable none;
+    string(none.resolve(entity.docs, entity, std::filesystem::path()), w);
+  }
+  w.write(",\"path\":");
+  string(entity.path.string(), w);
+  w.write(",\"lines\":");
+  if (entity.path.empty() || entity.type == EntityType::DIR) {
+    w.write("null");
+  } else {
+    /* lines are stored zero-based, but output one-based */
+    w.write("{\"start\":");
+    w.write(entity.start_line + 1ll);
+    w.write(",\"end\":");
+    w.write(entity.end_line + 1ll);
+    w.put('}');
+  }
+  w.write(",\"group\":");
+  if (group) {
+    string(group->name.view(), w);
+  } else {
+    w.write("null");
+  }
+
+  w.write(",\"children\":[");
+  const Entity* childGroup = entity.type == EntityType::GROUP ? &entity : group;
+  bool first = true;
+  for (auto list : Entity::lists) {
+    for (auto& child : entity.*list) {
+      if (!first) {
+        w.put(',');
+      }
+      first = false;
+      generate(child, childGroup, w);
+    }
+  }
+  w.write("]}");
+}
+
+void JSONExporter::string(const std::string_view& str, BufferedWriter& w) {
+  static const char hex[] = "0123456789abcdef";
+  w.put('"');
+  std::size_t from = 0;
+  for (std::size_t i = 0; i < str.size(); ++i) {
+    unsigned char c = str[i];
+    if (c == '"' || c == '\\' || c < 0x20) {
+      w.write(str.substr(from, i - from));
+      from = i + 1;
+      w.put('\\');
+      switch (c) {
+      case '"': w.put('"'); break;
+      case '\\': w.put('\\'); break;
+      case '\n': w.put('n'); break;
+      case '\t': w.put('t'); break;
+      case '\r': w.put('r'); break;
+      default:
+        w.write("u00");
+        w.put(hex[c >> 4]);
+        w.put(hex[c & 0xf]);
+      }
+    }
+  }
+  w.write(str.substr(from));
+  w.put('"');
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "BufferedWriter.hpp"
+#include "Entity.hpp"
+
+#include <ostream>
+#include <string_view>
+
+/**
+ * JSON exporter for the entity model.
+ *
+ * @ingroup developer
+ *
+ * Streams the whole entity tree in a single pass through a BufferedWriter,
+ * without building any intermediate representation. The schema is
+ * documented in `docs/exporting.md`; update it along with any change here,
+ * and increment the version number on any incompatible change.
+ */
+class JSONExporter {
+public:
+  /**
+   * Export the model.
+   *
+   * @param root Root entity.
+   * @param out Output stream.
+   */
+  void generate(const Entity& root, std::ostream& out);
+
+  /**
+   * Write a string as a quoted and escaped JSON string.
+   */
+  static void string(const std::string_view& str, BufferedWriter& w);
+
+private:
+  /**
+   * Recursively export an entity.
+   *
+   * @param entity Entity.
+   * @param group Name of the group to which the entity belongs, if any.
+   * @param w Writer.
+   */
+  static void generate(const Entity& entity, const Entity* group,
+      BufferedWriter& w);
+};
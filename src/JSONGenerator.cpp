@@ -41,7 +41,7 @@ int JSONGenerator::generate(const Entity& root, int nfiles) {
       * output 1-based */
     uint32_t nlines = 0;
     for (uint32_t line = 0; line < file.line_counts.size(); ++line) {
-      if (file.line_counts[line] >= 0) {
+      if (file.line_counts.included(line)) {
         if (nlines > 0) {
           std::cout << "," << std::endl;
         }
@@ -49,7 +49,7 @@ int JSONGenerator::generate(const Entity& root, int nfiles) {
         std::cout << "        {" << std::endl;
         std::cout << "          \"line_number\": " << (line + 1) << "," << std::endl;
         std::cout << "          \"branches\": []," << std::endl;
-        std::cout << "          \"count\": " << file.line_counts[line] << std::endl;
+        std::cout << "          \"count\": " << file.line_counts.count(line) << std::endl;
         std::cout << "        }";
       }
     }
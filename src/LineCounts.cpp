@@ -0,0 +1,111 @@
+#include "LineCounts.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+LineCounts::LineCounts() :
+    n(0) {
+  //
+}
+
+void LineCounts::resize(const uint32_t n) {
+  this->n = n;
+  included_words.resize(words(n), 0);
+  covered_words.resize(words(n), 0);
+
+  /* clear any bits beyond the end, and counts with them */
+  if (n % 64 != 0) {
+    uint64_t mask = (uint64_t(1) << (n % 64)) - 1;
+    included_words.back() &= mask;
+    covered_words.back() &= mask;
+  }
+  auto compare = [](const Count& c, const uint32_t line) {
+    return c.line < line;
+  };
+  sparse.erase(std::lower_bound(sparse.begin(), sparse.end(), n, compare),
+      sparse.end());
+}
+
+uint64_t LineCounts::count(const uint32_t line) const {
+  auto compare = [](const Count& c, const uint32_t line) {
+    return c.line < line;
+  };
+  auto iter = std::lower_bound(sparse.begin(), sparse.end(), line, compare);
+  return (iter != sparse.end() && iter->line == line) ? iter->count : 0;
+}
+
+bool LineCounts::include(const uint32_t line) {
+  if (line >= n || included(line)) {
+    return false;
+  } else {
+    included_words[line/64] |= uint64_t(1) << (line % 64);
+    return true;
+  }
+}
+
+bool LineCounts::add(const uint32_t line, const uint64_t count) {
+  if (count == 0 || !included(line)) {
+    return false;
+  }
+
+  /* counts usually arrive in line order, so check the end first */
+  auto compare = [](const Count& c, const uint32_t line) {
+    return c.line < line;
+  };
+  auto iter = (sparse.empty() || sparse.back().line < line) ? sparse.end() :
+      std::lower_bound(sparse.begin(), sparse.end(), line, compare);
+  if (iter != sparse.end() && iter->line == line) {
+    iter->count += count;
+    return false;
+  } else {
+    sparse.insert(iter, Count{line, count});
+    covered_words[line/64] |= uint64_t(1) << (line % 64);
+    return true;
+  }
+}
+
+void LineCounts::merge(const LineCounts& o) {
+  if (o.n > n) {
+    resize(o.n);
+  }
+  for (std::size_t i = 0; i < o.included_words.size(); ++i) {
+    included_words[i] |= o.included_words[i];
+    covered_words[i] |= o.covered_words[i];
+  }
+
+  std::vector<Count> merged;
+  merged.reserve(sparse.size() + o.sparse.size());
+  auto a = sparse.cbegin(), b = o.sparse.cbegin();
+  while (a != sparse.cend() && b != o.sparse.cend()) {
+    if (a->line < b->line) {
+      merged.push_back(*a++);
+    } else if (b->line < a->line) {
+      merged.push_back(*b++);
+    } else {
+      merged.push_back(Count{a->line, a->count + b->count});
+      ++a;
+      ++b;
+    }
+  }
+  merged.insert(merged.end(), a, sparse.cend());
+  merged.insert(merged.end(), b, o.sparse.end());
+  sparse = std::move(merged);
+}
+
+void LineCounts::assign(const uint32_t n, const uint64_t* included,
+    const uint64_t* covered, const Count* first, const Count* last) {
+  this->n = n;
+  included_words.assign(included, included + words(n));
+  covered_words.assign(covered, covered + words(n));
+  sparse.assign(first, last);
+}
+
+uint32_t LineCounts::popcount(const std::vector<uint64_t>& bits) {
+  /* simple loop over words, which compilers readily vectorize */
+  uint32_t total = 0;
+  for (auto word : bits) {
+    total += std::popcount(word);
+  }
+  return total;
+}
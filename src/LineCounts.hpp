@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Execution counts for the lines of a source file.
+ *
+ * @ingroup developer
+ *
+ * Each line is either excluded from coverage counts, included but not
+ * covered (executed zero times), or covered (executed one or more times).
+ * Most lines of a typical source file are of the first two kinds, so rather
+ * than store a count for every line, the representation is two bitmaps---one
+ * of included lines, one of covered lines---and a sparse store of the
+ * counts of covered lines only, sorted by line. Totals are computed by
+ * population count over the bitmaps. Counts are 64-bit, as execution counts
+ * summed over a large test suite can exceed the range of `int`.
+ */
+class LineCounts {
+public:
+  /**
+   * Count for a covered line.
+   */
+  struct Count {
+    /**
+     * Line number, zero-based.
+     */
+    uint32_t line;
+
+    /**
+     * Execution count.
+     */
+    uint64_t count;
+  };
+
+  /**
+   * Constructor. There are no lines.
+   */
+  LineCounts();
+
+  /**
+   * Set the number of lines. Any new lines are excluded.
+   *
+   * @param n Number of lines.
+   */
+  void resize(const uint32_t n);
+
+  /**
+   * Number of lines.
+   */
+  uint32_t size() const {
+    return n;
+  }
+
+  /**
+   * Is a line included?
+   */
+  bool included(const uint32_t line) const {
+    return test(included_words, line);
+  }
+
+  /**
+   * Is a line covered?
+   */
+  bool covered(const uint32_t line) const {
+    return test(covered_words, line);
+  }
+
+  /**
+   * Execution count of a line. This is zero for a line that is not covered.
+   */
+  uint64_t count(const uint32_t line) const;
+
+  /**
+   * Include a line.
+   *
+   * @param line Line number.
+   *
+   * @return True if the line was excluded and is now included, false if it
+   * was already included.
+   */
+  bool include(const uint32_t line);
+
+  /**
+   * Add to the execution count of a line. If the line is excluded, or the
+   * count is zero, does nothing.
+   *
+   * @param line Line number.
+   * @param count Execution count.
+   *
+   * @return True if the line was included but not covered, and is now
+   * covered.
+   */
+  bool add(const uint32_t line, const uint64_t count);
+
+  /**
+   * Merge with another set of line counts for the same file. A line is
+   * included if included in either, and counts are summed.
+   */
+  void merge(const LineCounts& o);
+
+  /**
+   * Number of lines included.
+   */
+  uint32_t nincluded() const {
+    return popcount(included_words);
+  }
+
+  /**
+   * Number of lines covered.
+   */
+  uint32_t ncovered() const {
+    return popcount(covered_words);
+  }
+
+  /**
+   * Bitmap of included lines, with line `i` at bit `i % 64` of word
+   * `i / 64`.
+   */
+  const std::vector<uint64_t>& included_bits() const {
+    return included_words;
+  }
+
+  /**
+   * Bitmap of covered lines, as for included_bits().
+   */
+  const std::vector<uint64_t>& covered_bits() const {
+    return covered_words;
+  }
+
+  /**
+   * Counts of covered lines, sorted by line.
+   */
+  const std::vector<Count>& counts() const {
+    return sparse;
+  }
+
+  /**
+   * Assign from the representation given by included_bits(), covered_bits()
+   * and counts(), e.g. when reading a snapshot.
+   *
+   * @param n Number of lines.
+   * @param included Bitmap of included lines.
+   * @param covered Bitmap of covered lines.
+   * @param first First count.
+   * @param last One past last count.
+   */
+  void assign(const uint32_t n, const uint64_t* included,
+      const uint64_t* covered, const Count* first, const Count* last);
+
+  /**
+   * Number of words for a given number of lines.
+   */
+  static uint32_t words(const uint32_t n) {
+    return (n + 63)/64;
+  }
+
+private:
+  static bool test(const std::vector<uint64_t>& bits, const uint32_t line) {
+    return line < bits.size()*64 && ((bits[line/64] >> (line % 64)) & 1);
+  }
+
+  static uint32_t popcount(const std::vector<uint64_t>& bits);
+
+  /**
+   * Number of lines.
+   */
+  uint32_t n;
+
+  /**
+   * Bitmap of included lines.
+   */
+  std::vector<uint64_t> included_words;
+
+  /**
+   * Bitmap of covered lines, a subset of those included.
+   */
+  std::vector<uint64_t> covered_words;
+
+  /**
+   * Counts of covered lines, sorted by line.
+   */
+  std::vector<Count> sparse;
+};
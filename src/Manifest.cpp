@@ -0,0 +1,126 @@
+#include "Manifest.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+/**
+ * Name of the manifest file in the output directory.
+ *
+ * @ingroup developer
+ */
+static const char* MANIFEST_NAME = ".doxide.manifest";
+
+/**
+ * First line of the manifest file.
+ *
+ * @ingroup developer
+ */
+static const char* MANIFEST_HEADER = "# doxide manifest 1";
+
+Manifest::Manifest(const std::filesystem::path& output) :
+    output(output) {
+  //
+}
+
+bool Manifest::load() {
+  entries.clear();
+  std::filesystem::path path = output / MANIFEST_NAME;
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(in, line) || line != MANIFEST_HEADER) {
+    throw std::runtime_error("unrecognized manifest " + path.string());
+  }
+  while (std::getline(in, line)) {
+    uint64_t hash = 0;
+    const char* first = line.data();
+    const char* last = line.data() + line.size();
+    auto [ptr, ec] = std::from_chars(first, last, hash, 16);
+    if (ec != std::errc() || ptr != first + 16 || ptr == last ||
+        *ptr != ' ' || ptr + 1 == last) {
+      throw std::runtime_error("malformed manifest " + path.string());
+    }
+
+    /* the manifest is a plain text file, so may be edited or corrupted;
+     * entries are removed when no longer generated, so reject any that
+     * could name a file outside of the output directory */
+    std::filesystem::path name(std::string(ptr + 1, last));
+    if (name.has_root_path() || std::find(name.begin(), name.end(), "..") !=
+        name.end()) {
+      throw std::runtime_error("malformed manifest " + path.string());
+    }
+    entries.insert_or_assign(name.generic_string(), hash);
+  }
+  return true;
+}
+
+void Manifest::save() const {
+  std::filesystem::path path = output / MANIFEST_NAME;
+  if (entries.empty()) {
+    std::filesystem::remove(path);
+    return;
+  }
+
+  /* write to a temporary file then rename, as for pages */
+  std::filesystem::path tmp = path;
+  tmp += ".tmp";
+  std::ofstream out(tmp, std::ios::binary);
+  out << MANIFEST_HEADER << '\n';
+  for (auto& [name, hash] : entries) {
+    char buf[16];
+    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), hash, 16);
+    out << std::string(16 - (ptr - buf), '0') << std::string_view(buf, ptr);
+    out << ' ' << name << '\n';
+  }
+  out.close();
+  if (!out) {
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+    throw std::runtime_error("could not write " + path.string());
+  }
+  std::filesystem::rename(tmp, path);
+}
+
+bool Manifest::contains(const std::filesystem::path& file) const {
+  return entries.contains(key(file));
+}
+
+bool Manifest::find(const std::filesystem::path& file, uint64_t& hash) const {
+  auto iter = entries.find(key(file));
+  if (iter != entries.end()) {
+    hash = iter->second;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+void Manifest::insert(const std::filesystem::path& file, const uint64_t hash) {
+  entries.insert_or_assign(key(file), hash);
+}
+
+std::map<std::filesystem::path,uint64_t> Manifest::files() const {
+  std::map<std::filesystem::path,uint64_t> result;
+  for (auto& [name, hash] : entries) {
+    result.emplace(output / std::filesystem::path(name), hash);
+  }
+  return result;
+}
+
+uint64_t Manifest::hash(const std::string_view& contents) {
+  uint64_t h = 14695981039346656037ull;
+  for (unsigned char c : contents) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+std::string Manifest::key(const std::filesystem::path& file) const {
+  return file.lexically_relative(output).generic_string();
+}
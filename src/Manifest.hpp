@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+
+/**
+ * Manifest of the files generated in an output directory.
+ *
+ * @ingroup developer
+ *
+ * The manifest is kept in the output directory itself, in a file named
+ * `.doxide.manifest`. It lists the files generated by the last build,
+ * relative to the output directory, with a hash of their contents. Files in
+ * the manifest are known to be owned by Doxide, so may be overwritten, or
+ * removed when no longer generated, without having to be opened. The file is
+ * plain text, with one entry per line: the hash as 16 hexadecimal digits, a
+ * space, then the path. A path that is absolute, or that contains a `..`
+ * component, is rejected as malformed.
+ */
+class Manifest {
+public:
+  /**
+   * Constructor.
+   *
+   * @param output Output directory.
+   */
+  Manifest(const std::filesystem::path& output);
+
+  /**
+   * Load the manifest from the output directory. If it does not exist, the
+   * manifest is left empty.
+   *
+   * @return True if the manifest exists and was loaded, false otherwise.
+   */
+  bool load();
+
+  /**
+   * Save the manifest to the output directory. If the manifest is empty,
+   * any existing manifest file is removed instead.
+   */
+  void save() const;
+
+  /**
+   * Does the manifest contain a file?
+   *
+   * @param file File path, including the output directory.
+   */
+  bool contains(const std::filesystem::path& file) const;
+
+  /**
+   * Hash of a file in the manifest.
+   *
+   * @param file File path, including the output directory.
+   * @param[out] hash The hash, if found.
+   *
+   * @return True if found, false otherwise.
+   */
+  bool find(const std::filesystem::path& file, uint64_t& hash) const;
+
+  /**
+   * Insert a file into the manifest, or update its hash.
+   *
+   * @param file File path, including the output directory.
+   * @param hash Hash of its contents.
+   */
+  void insert(const std::filesystem::path& file, const uint64_t hash);
+
+  /**
+   * Number of files in the manifest.
+   */
+  std::size_t size() const {
+    return entries.size();
+  }
+
+  /**
+   * Files in the manifest, as paths including the output directory, with
+   * their hashes.
+   */
+  std::map<std::filesystem::path,uint64_t> files() const;
+
+  /**
+   * Hash of file contents, using 64-bit FNV-1a.
+   */
+  static uint64_t hash(const std::string_view& contents);
+
+private:
+  /**
+   * Key for a file, which is its path relative to the output directory.
+   */
+  std::string key(const std::filesystem::path& file) const;
+
+  /**
+   * Output directory.
+   */
+  std::filesystem::path output;
+
+  /**
+   * Entries, by path relative to the output directory. Ordered, so that the
+   * manifest file is identical for identical output.
+   */
+  std::map<std::string,uint64_t> entries;
+};
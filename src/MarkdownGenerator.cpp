@@ -1,72 +1,1105 @@
 #include "MarkdownGenerator.hpp"
 
+#include "Highlight.hpp"
 #include "Log.hpp"
-#include "Regex.hpp"
-#include "YAMLNode.hpp"
-#include "YAMLParser.hpp"
+#include "WorkerPool.hpp"
+#include "WriteQueue.hpp"
 
 #include <stdint.h>
 #include <algorithm>
+#include <bit>
 #include <cassert>
+#include <charconv>
+#include <cctype>
 #include <compare>
+#include <cstddef>
+#include <fstream>
 #include <iomanip>
 #include <iterator>
-#include <regex>
+#include <set>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
-MarkdownGenerator::MarkdownGenerator(const std::filesystem::path& output) :
-    output(output) {
-  //
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * Find the first character of a string that is one of a given set. Where
+ * SSE2 is available, sixteen characters are tested at a time.
+ *
+ * @ingroup developer
+ *
+ * @tparam Cs Characters to find.
+ *
+ * @param str String.
+ * @param from Position from which to search.
+ *
+ * @return Position of the first such character, or the length of the string
+ * if there is none.
+ */
+template<char... Cs>
+static std::size_t find_any(const std::string_view& str, std::size_t from) {
+  const char* data = str.data();
+  const std::size_t n = str.size();
+  std::size_t i = from;
+#ifdef HAVE_SSE2
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i m = _mm_setzero_si128();
+    ((m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(Cs)))), ...);
+    unsigned mask = _mm_movemask_epi8(m);
+    if (mask) {
+      return i + std::countr_zero(mask);
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    const char c = data[i];
+    if (((c == Cs) || ...)) {
+      return i;
+    }
+  }
+  return n;
+}
+
+/**
+ * Is a character a word character for sanitize(), i.e. a letter, digit,
+ * underscore, period, or forward or backward slash?
+ *
+ * @ingroup developer
+ */
+static bool is_word(const char c) {
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+      ('0' <= c && c <= '9') || c == '_' || c == '.' || c == '/' ||
+      c == '\\';
+}
+
+/**
+ * Is a character whitespace? As `\s` in a regular expression, or
+ * std::isspace(), in the classic locale.
+ *
+ * @ingroup developer
+ */
+static bool is_space(const char c) {
+  return c == ' ' || ('\t' <= c && c <= '\r');
+}
+
+/**
+ * Find the first character of a string that is not a word character, as
+ * for is_word(). Where SSE2 is available, sixteen characters are tested at a
+ * time; characters outside the ASCII range are negative as signed bytes, so
+ * fall outside all of the ranges tested.
+ *
+ * @ingroup developer
+ *
+ * @return Position of the first such character, or the length of the string
+ * if there is none.
+ */
+static std::size_t find_not_word(const std::string_view& str,
+    std::size_t from) {
+  const char* data = str.data();
+  const std::size_t n = str.size();
+  std::size_t i = from;
+#ifdef HAVE_SSE2
+  auto range = [](__m128i v, const char lo, const char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+        _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+  };
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i m = _mm_or_si128(_mm_or_si128(range(v, 'a', 'z'),
+        range(v, 'A', 'Z')), range(v, '.', '9'));  // ./0-9
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    unsigned mask = ~unsigned(_mm_movemask_epi8(m)) & 0xffffu;
+    if (mask) {
+      return i + std::countr_zero(mask);
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    if (!is_word(data[i])) {
+      return i;
+    }
+  }
+  return n;
+}
+
+/**
+ * Match the first sentence of a string, for brief(). Gives the same result
+ * as a search with the regular expression
+ * `^(`.*?`|\[.*?\]\(.*?\)|\x02[^\x03]*\x03|[^;:.?!])*[\.\?\!](?=\s|$)`,
+ * i.e. a sequence of code spans, links, cross-reference markers (see
+ * SymbolTable) and single characters other than punctuation, followed by a
+ * period, question mark or exclamation mark, then whitespace or the end of
+ * the string.
+ *
+ * @ingroup developer
+ *
+ * @param str String.
+ * @param i Position from which to match.
+ * @param failed Positions from which a match is known to fail.
+ *
+ * @return One past the end of the match, or `std::string::npos` if there is
+ * no match.
+ *
+ * Alternatives are tried in the order that a backtracking regular
+ * expression engine would try them, with the repetition greedy and the code
+ * spans and links lazy, so that the match is the same. The result from each
+ * position does not depend on how it was reached, so failures are memoized,
+ * which keeps the time linear in the common case.
+ */
+static std::size_t sentence(const std::string_view& str, std::size_t i,
+    std::vector<char>& failed) {
+  static constexpr std::size_t npos = std::string::npos;
+  const std::size_t n = str.size();
+  auto eol = [](const char c) {
+    /* not matched by `.` */
+    return c == '\n' || c == '\r';
+  };
+
+  /* any other character can only be matched as a single character, after
+   * which the match continues with the next */
+  i = find_any<';',':','.','?','!','`','[','\x02'>(str, i);
+  if (i == n || failed[i]) {
+    return npos;
+  }
+  const char c = str[i];
+  std::size_t r = npos;
+  if (c == '`') {
+    for (std::size_t j = i + 1; r == npos && j < n && !eol(str[j]); ++j) {
+      if (str[j] == '`') {
+        r = sentence(str, j + 1, failed);
+      }
+    }
+  } else if (c == '[') {
+    for (std::size_t j = i + 1; r == npos && j + 1 < n && !eol(str[j]); ++j) {
+      if (str[j] == ']' && str[j + 1] == '(') {
+        for (std::size_t k = j + 2; r == npos && k < n && !eol(str[k]); ++k) {
+          if (str[k] == ')') {
+            r = sentence(str, k + 1, failed);
+          }
+        }
+      }
+    }
+  } else if (c == '\x02') {
+    std::size_t j = str.find('\x03', i + 1);
+    if (j != npos) {
+      r = sentence(str, j + 1, failed);
+    }
+  }
+  if (r == npos && c != ';' && c != ':' && c != '.' && c != '?' && c != '!') {
+    r = sentence(str, i + 1, failed);
+  }
+  if (r == npos && (c == '.' || c == '?' || c == '!') &&
+      (i + 1 == n || is_space(str[i + 1]))) {
+    r = i + 1;
+  }
+  if (r == npos) {
+    failed[i] = true;
+  }
+  return r;
+}
+
+/**
+ * Script for code coverage report pages, written to the coverage directory.
+ *
+ * @ingroup developer
+ */
+static const char* coverage_js = R""""(/* Doxide code coverage */
+
+/* parse run-length ranges of lines, e.g. "1-4,7,9-12" */
+function doxide_ranges(str) {
+  let ranges = [];
+  for (let range of (str || '').split(',')) {
+    if (range) {
+      let [first, last] = range.split('-').map(Number);
+      ranges.push([first, last === undefined ? first : last]);
+    }
+  }
+  return ranges;
+}
+
+/* highlight covered and uncovered lines of a source listing; line numbers
+ * are in a <pre> that holds one empty <span>, then one <span> per line */
+function doxide_lines() {
+  let lines = document.querySelector('.doxide-lines');
+  let pre = document.querySelector('.linenodiv pre');
+  if (lines && pre) {
+    let spans = pre.children;
+    for (let [attr, cls] of [['covered', 'doxide-covered'],
+        ['uncovered', 'doxide-uncovered']]) {
+      for (let [first, last] of doxide_ranges(lines.dataset[attr])) {
+        for (let line = first; line <= last && line < spans.length; ++line) {
+          spans[line].classList.add(cls);
+        }
+      }
+    }
+  }
+}
+
+/* color and icon for a percentage, as for the tables */
+function doxide_color(percent) {
+  if (percent < 60.0) {
+    return 'ef5552';
+  } else if (percent < 70.0) {
+    return 'f78b2b';
+  } else if (percent < 80.0) {
+    return 'ffc105';
+  } else if (percent < 90.0) {
+    return 'a5b72a';
+  } else {
+    return '4cae4f';
+  }
+}
+
+function doxide_icon(percent) {
+  if (percent < 60.0) {
+    return '○○○○';
+  } else if (percent < 70.0) {
+    return '●○○○';
+  } else if (percent < 80.0) {
+    return '●●○○';
+  } else if (percent < 90.0) {
+    return '●●●○';
+  } else {
+    return '●●●●';
+  }
+}
+
+/* find the node of the coverage data at a path, e.g. "src/util" */
+function doxide_find(node, path) {
+  for (let name of path.split('/')) {
+    if (name && node) {
+      node = (node.children || []).find(child => child.name === name);
+    }
+  }
+  return node;
+}
+
+/* nodes of the coverage data by path relative to the root of the chart,
+ * with the relative URLs of their pages */
+var doxide_nodes = {};
+
+/* convert nodes of the coverage data to sunburst chart data, with paths
+ * relative to the root of the chart */
+function doxide_sunburst_data(nodes, parent, href) {
+  return nodes.map(node => {
+    let percent = node.lines > 0 ? 100.0*node.covered/node.lines : 100.0;
+    let c = doxide_color(percent);
+    let path = parent ? parent + '/' + node.name : node.name;
+    let page = href ? href + '/' + node.page : node.page;
+    doxide_nodes[path] = { node: node, href: page };
+    let item = {
+      name: node.name,
+      path: path,
+      value: node.lines,
+      type: node.children ? 'dir' : 'file',
+      icon: doxide_icon(percent),
+      itemStyle: { color: '#' + c + 'dd', borderColor: '#' + c },
+      label: { textBorderColor: '#' + c }
+    };
+    if (node.children) {
+      item.children = doxide_sunburst_data(node.children, path, page);
+    }
+    return item;
+  });
+}
+
+function doxide_escape(str) {
+  return String(str).replace(/[&<>"]/g, c => '&#' + c.charCodeAt(0) + ';');
+}
+
+/* row of the coverage table for a node linked to its page, or without a
+ * link for the summary row */
+function doxide_row(node, href) {
+  let percent = node.lines > 0 ? 100.0*node.covered/node.lines : 100.0;
+  let bold = href === undefined ? 'font-weight:bold;' : '';
+  let name = 'Summary';
+  let sort = '';
+  if (href !== undefined) {
+    let dir = node.children !== undefined;
+    name = '<span class="' + (dir ? 'doxide-folder' : 'doxide-file') +
+        '"></span> <a href="' + doxide_escape(href) + '/">' +
+        doxide_escape(node.name) + '</a>';
+    sort = ' data-sort="' + (dir ? 'a.' : 'b.') + doxide_escape(node.page) +
+        '"';
+  }
+  let cell = value => '<td style="text-align:right;' + bold + '">' + value +
+      '</td>';
+  return '<tr><td style="text-align:left;' + bold + '"' + sort + '>' + name +
+      '</td>' + cell(node.lines) + cell(node.covered) +
+      cell(node.lines - node.covered) +
+      '<td style="text-align:right;' + bold + 'box-shadow: -8px 0 0 0 #' +
+      doxide_color(percent) + 'dd inset;">' + percent.toFixed(1) +
+      '%</td></tr>';
+}
+
+/* replace the rows of the coverage table with those for a selection in the
+ * sunburst chart: for a directory, its children and summary, for a file,
+ * just the file */
+var coverage_root = "";  // current root of coverage report
+function update_coverage_table(params) {
+  if (typeof params.data.name === 'undefined') {
+    // occurs when the central circle is selected to go up one level
+    var path = coverage_root.substring(0, coverage_root.lastIndexOf('/'));
+  } else {
+    var path = params.data.path;
+  }
+  let selected = doxide_nodes[path];
+  let table = document.getElementById('coverage-table');
+  if (selected && table) {
+    let rows = '';
+    let foot = '';
+    if (selected.node.children) {
+      for (let child of selected.node.children) {
+        rows += doxide_row(child, selected.href ?
+            selected.href + '/' + child.page : child.page);
+      }
+      foot = doxide_row(selected.node);
+    } else {
+      rows = doxide_row(selected.node, selected.href);
+    }
+    table.tBodies[0].innerHTML = rows;
+    table.tFoot.innerHTML = foot;
+  }
+  coverage_root = path;
+}
+
+function doxide_sunburst(root, data) {
+  let node = doxide_find(data, root.dataset.root);
+  if (!node) {
+    return;
+  }
+  doxide_nodes[''] = { node: node, href: '' };
+  let coverage_sunburst = echarts.init(root);
+  let option = {
+    series: {
+      type: 'sunburst',
+      data: doxide_sunburst_data(node.children || [], '', ''),
+      sort: null,
+      radius: ['5%', '95%'],
+      startAngle: 0,
+      clockwise: false,
+      itemStyle: {
+        borderWidth: 1
+      },
+      label: {
+        color: 'white',
+        fontSize: 10,
+        textBorderWidth: 1,
+        align: 'center',
+        rotate: 'radial',
+        width: 80,
+        minAngle: 4,
+        overflow: 'truncate',
+        formatter: function (params) {
+          if (params.data.icon) {
+            return params.name + '\n' + params.data.icon;
+          } else {
+            return params.name;
+          }
+        }
+      },
+      labelLayout: {
+        hideOverlap: true
+      },
+      levels: [
+        {
+          itemStyle: {
+            opacity: 0.2
+          }
+        }
+      ]
+    }
+  };
+  coverage_sunburst.setOption(option);
+  coverage_sunburst.on('click', update_coverage_table);
+  window.addEventListener("resize", () => {
+    coverage_sunburst.resize();
+  });
+}
+
+/* the coverage data is shared by all pages, alongside this script */
+var doxide_data_url = new URL('coverage.json', document.currentScript.src);
+
+function doxide_coverage() {
+  doxide_lines();
+  let root = document.getElementById('coverage-sunburst');
+  if (root) {
+    fetch(doxide_data_url)
+      .then(response => response.json())
+      .then(data => doxide_sunburst(root, data));
+  }
+}
+
+if (document.readyState === 'loading') {
+  document.addEventListener('DOMContentLoaded', doxide_coverage);
+} else {
+  doxide_coverage();
+}
+)"""";
+
+/**
+ * Style sheet for code coverage report pages, written to the coverage
+ * directory.
+ *
+ * @ingroup developer
+ */
+static const char* coverage_css = R""""(/* Doxide code coverage */
+.linenodiv pre span {
+  padding-left: 4px;
+  padding-right: 4px;
+}
+.linenodiv pre span.doxide-covered {
+  background-color: #4cae4fdd;
+  color: white;
+}
+.linenodiv pre span.doxide-covered::before {
+  content: "● ";
+}
+.linenodiv pre span.doxide-uncovered {
+  background-color: #ef5552dd;
+  color: white;
+}
+.linenodiv pre span.doxide-uncovered::before {
+  content: "○ ";
+}
+.doxide-folder, .doxide-file {
+  display: inline-block;
+  width: 1.125em;
+  height: 1.125em;
+  vertical-align: text-top;
+  background-color: currentColor;
+  -webkit-mask: var(--doxide-icon) no-repeat center / contain;
+  mask: var(--doxide-icon) no-repeat center / contain;
+}
+.doxide-folder {
+  --doxide-icon: url("data:image/svg+xml;utf8,<svg xmlns='http://www.w3.org/2000/svg' viewBox='0 0 24 24'><path d='M10 4H4c-1.11 0-2 .89-2 2v12a2 2 0 0 0 2 2h16a2 2 0 0 0 2-2V8a2 2 0 0 0-2-2h-8z'/></svg>");
+}
+.doxide-file {
+  --doxide-icon: url("data:image/svg+xml;utf8,<svg xmlns='http://www.w3.org/2000/svg' viewBox='0 0 24 24'><path d='M14 2H6a2 2 0 0 0-2 2v16a2 2 0 0 0 2 2h12a2 2 0 0 0 2-2V8zm4 18H6V4h7v5h5z'/></svg>");
+}
+)"""";
+
+/**
+ * Script for the search index, written to the search directory.
+ *
+ * @ingroup developer
+ */
+static const char* search_js = R""""(/* Doxide search */
+
+/* shards of the index are alongside this script, and URLs in the index are
+ * relative to the directory above */
+var doxide_search_base = new URL('.', document.currentScript.src);
+var doxide_search_root = new URL('..', document.currentScript.src);
+var doxide_search_shards = {};
+
+/* shard key for a name, as SearchIndex::key() */
+function doxide_search_key(name) {
+  let key = name.substring(0, 2).toLowerCase().replace(/[^a-z0-9_]/g, '_');
+  return key || '_';
 }
 
-void MarkdownGenerator::generate(const Entity& root, const bool cov) {
+/* fetch a shard, once */
+function doxide_search_shard(key) {
+  if (!(key in doxide_search_shards)) {
+    doxide_search_shards[key] = fetch(new URL(key + '.json', doxide_search_base))
+      .then(response => response.ok ? response.json() : [])
+      .catch(() => []);
+  }
+  return doxide_search_shards[key];
+}
+
+/* brief descriptions are Markdown; keep just the text of links */
+function doxide_search_text(brief) {
+  return brief.replace(/\[([^\]]*)\]\([^)]*\)/g, '$1').replace(/[*`]/g, '');
+}
+
+/* update results for the query in the input; the query is matched against
+ * the start of names, or, if it contains "::", against qualified names;
+ * shards are keyed by the first two characters of names, so a query of one
+ * character matches only names of that one character, and prompts for more */
+function doxide_search(input, results) {
+  let query = input.value.trim();
+  let scope = query.lastIndexOf('::');
+  let name = scope >= 0 ? query.substring(scope + 2) : query;
+  if (!name) {
+    results.replaceChildren();
+    return;
+  }
+  doxide_search_shard(doxide_search_key(name)).then(entries => {
+    if (input.value.trim() !== query) {
+      return;  // superseded by further typing
+    }
+    let lower = name.toLowerCase();
+    let qualified = query.toLowerCase();
+    let matches = entries.filter(entry =>
+        entry[0].toLowerCase().startsWith(lower) &&
+        (scope < 0 || entry[1].toLowerCase().includes(qualified)));
+    matches.sort((a, b) => (b[0].toLowerCase() === lower) -
+        (a[0].toLowerCase() === lower) || a[0].length - b[0].length);
+    let items = matches.slice(0, 50).map(entry => {
+      let item = document.createElement('li');
+      let link = document.createElement('a');
+      link.href = new URL(entry[3], doxide_search_root).href;
+      let title = document.createElement('span');
+      title.className = 'doxide-search__name';
+      title.textContent = entry[1];
+      let kind = document.createElement('span');
+      kind.className = 'doxide-search__kind';
+      kind.textContent = entry[2];
+      let brief = document.createElement('span');
+      brief.className = 'doxide-search__brief';
+      brief.textContent = doxide_search_text(entry[4]);
+      link.append(title, kind, brief);
+      item.append(link);
+      return item;
+    });
+    if (name.length < 2) {
+      let hint = document.createElement('li');
+      hint.className = 'doxide-search__hint';
+      hint.textContent = 'Type another character to search all names';
+      items.push(hint);
+    }
+    results.replaceChildren(...items);
+  });
+}
+
+function doxide_search_init() {
+  let box = document.createElement('div');
+  box.className = 'doxide-search';
+  let input = document.createElement('input');
+  input.type = 'search';
+  input.placeholder = 'Search';
+  input.setAttribute('aria-label', 'Search');
+  let results = document.createElement('ol');
+  results.className = 'doxide-search__results';
+  box.append(input, results);
+
+  /* place in the header of Material for MkDocs, if present */
+  let header = document.querySelector('.md-header__inner');
+  if (header) {
+    header.insertBefore(box, header.querySelector('.md-header__source'));
+  } else {
+    document.body.prepend(box);
+  }
+
+  input.addEventListener('input', () => doxide_search(input, results));
+  input.addEventListener('keydown', event => {
+    if (event.key === 'Escape') {
+      input.value = '';
+      results.replaceChildren();
+    } else if (event.key === 'Enter') {
+      let first = results.querySelector('a');
+      if (first) {
+        window.location.href = first.href;
+      }
+    }
+  });
+}
+
+if (document.readyState === 'loading') {
+  document.addEventListener('DOMContentLoaded', doxide_search_init);
+} else {
+  doxide_search_init();
+}
+)"""";
+
+/**
+ * Style sheet for the search index, written to the search directory.
+ *
+ * @ingroup developer
+ */
+static const char* search_css = R""""(/* Doxide search */
+.doxide-search {
+  position: relative;
+  margin: 0 0.8rem;
+}
+.doxide-search input {
+  width: 12rem;
+  padding: 0.3rem 0.6rem;
+  border: none;
+  border-radius: 0.1rem;
+  background-color: rgba(0, 0, 0, 0.26);
+  color: inherit;
+  font: inherit;
+}
+.doxide-search input::placeholder {
+  color: inherit;
+  opacity: 0.7;
+}
+.doxide-search__results {
+  position: absolute;
+  right: 0;
+  z-index: 10;
+  width: 32rem;
+  max-width: 90vw;
+  max-height: 70vh;
+  margin: 0.2rem 0 0 0;
+  padding: 0;
+  overflow-y: auto;
+  list-style: none;
+  background-color: var(--md-default-bg-color, white);
+  color: var(--md-default-fg-color, black);
+  box-shadow: 0 0.2rem 0.5rem rgba(0, 0, 0, 0.3);
+}
+.doxide-search__results:empty {
+  display: none;
+}
+.doxide-search__results a {
+  display: block;
+  padding: 0.4rem 0.8rem;
+  color: inherit;
+  font-size: 0.7rem;
+  line-height: 1.4;
+}
+.doxide-search__results a:hover, .doxide-search__results a:focus {
+  background-color: var(--md-accent-fg-color--transparent, #eee);
+}
+.doxide-search__name {
+  font-family: var(--md-code-font-family, monospace);
+  font-weight: bold;
+}
+.doxide-search__kind {
+  margin-left: 0.5rem;
+  opacity: 0.6;
+}
+.doxide-search__brief {
+  display: block;
+  opacity: 0.8;
+}
+.doxide-search__hint {
+  padding: 0.4rem 0.8rem;
+  font-size: 0.7rem;
+  opacity: 0.6;
+}
+)"""";
+
+/**
+ * Kinds of entities in the search index, by EntityType.
+ *
+ * @ingroup developer
+ */
+static const char* search_kinds[] = {
+  "root",
+  "namespace",
+  "template",
+  "group",
+  "type",
+  "typedef",
+  "concept",
+  "variable",
+  "function",
+  "operator",
+  "enumerator",
+  "macro",
+  "dir",
+  "file"
+};
+
+/**
+ * Kinds of page, by which templates are selected, in the order of
+ * `template_kinds`.
+ *
+ * @ingroup developer
+ */
+enum TemplateKind {
+  TEMPLATE_ROOT,
+  TEMPLATE_GROUP,
+  TEMPLATE_NAMESPACE,
+  TEMPLATE_TYPE,
+  TEMPLATE_PART,
+  TEMPLATE_COVERAGE_ROOT,
+  TEMPLATE_COVERAGE_DIR,
+  TEMPLATE_COVERAGE_FILE
+};
+
+/**
+ * Names of the kinds of page, as for the files of templates.
+ *
+ * @ingroup developer
+ */
+static const char* template_kinds[] = {
+  "root",
+  "group",
+  "namespace",
+  "type",
+  "part",
+  "coverage-root",
+  "coverage-dir",
+  "coverage-file"
+};
+
+/**
+ * Append a run of lines to comma-separated ranges, as `first-last`, or just
+ * `first` for a single line.
+ *
+ * @ingroup developer
+ *
+ * @param ranges Ranges.
+ * @param first First line of the run, 1-based.
+ * @param last Last line of the run, 1-based.
+ */
+static void append_range(std::string& ranges, const uint32_t first,
+    const uint32_t last) {
+  if (!ranges.empty()) {
+    ranges += ',';
+  }
+  ranges += std::to_string(first);
+  if (last != first) {
+    ranges += '-';
+    ranges += std::to_string(last);
+  }
+}
+
+/**
+ * Letter by which a member is filed when the page of its parent is split:
+ * its initial, in lowercase, or an underscore if that is not a letter.
+ *
+ * @ingroup developer
+ */
+static char initial(const std::string_view& name) {
+  unsigned char c = name.empty() ? '_' : name[0];
+  return std::isalpha(c) ? std::tolower(c) : '_';
+}
+
+/**
+ * Estimated size of the details of a member on a page, in bytes.
+ *
+ * @ingroup developer
+ */
+static std::size_t estimate(const Entity& entity) {
+  /* heading, admonition and declaration, which may be linked or
+   * highlighted, then the documentation, indented */
+  std::size_t decl = entity.path.styles(entity.decl).empty() ? 2 : 6;
+  return 64 + 2*entity.name.str().size() + decl*entity.decl.size() +
+      entity.docs.size() + entity.docs.size()/16;
+}
+
+/**
+ * Scope by which to qualify the name of an entity, ending in `::` unless
+ * global: the scope from which it was moved into a group, if any (see
+ * Entity::scope), otherwise that of its parent.
+ *
+ * @ingroup developer
+ *
+ * @param entity Entity.
+ * @param scope Scope of its parent, ending in `::` unless global.
+ */
+static std::string qualifier(const Entity& entity, const std::string& scope) {
+  return entity.scope.empty() ? scope : entity.scope + "::";
+}
+
+/**
+ * Styles of a string as reduced to a single line by
+ * MarkdownGenerator::line().
+ *
+ * @ingroup developer
+ *
+ * @param str Original string.
+ * @param styles Styles of the original string, one per byte.
+ * @param line Reduced string.
+ *
+ * @return Styles of the reduced string, one per byte.
+ */
+static std::string line_styles(const std::string_view& str,
+    const std::string_view& styles, const std::string& line) {
+  /* reduction only replaces runs of whitespace, so each other character of
+   * the reduced string is the next such character of the original */
+  std::string r(line.size(), char(Highlight::NONE));
+  std::size_t j = 0;
+  for (std::size_t i = 0; i < line.size(); ++i) {
+    if (!is_space(line[i])) {
+      while (j < str.size() && str[j] != line[i]) {
+        ++j;
+      }
+      if (j < str.size()) {
+        r[i] = styles[j++];
+      }
+    }
+  }
+  return r;
+}
+
+MarkdownGenerator::MarkdownGenerator(const std::filesystem::path& output,
+    const bool html, const std::size_t split_members,
+    const std::size_t split_bytes, const std::filesystem::path& archive,
+    const std::filesystem::path& templates) :
+    output(output),
+    html_generator(output),
+    site_search(false),
+    html(html),
+    split_members(split_members),
+    split_bytes(split_bytes),
+    tar(archive.empty() ? nullptr : std::make_unique<TarWriter>(archive)),
+    previous(output),
+    current(output),
+    contributors(output),
+    nchanged(0) {
+  for (auto kind : template_kinds) {
+    this->templates.emplace_back(kind, templates);
+  }
+  try {
+    has_previous = previous.load();
+  } catch (const std::runtime_error& e) {
+    warn(e.what());
+    has_previous = false;
+  }
+  try {
+    contributors.load();
+  } catch (const std::runtime_error& e) {
+    /* only needed for partial builds, and rebuilt by a full build */
+    warn(e.what());
+  }
+}
+
+void MarkdownGenerator::generate(const Entity& root, const bool cov,
+    const bool search) {
+  plans.clear();
+  symbols.clear();
+  prepare(root);
+  index(output, root);
+  describe(root, output);
+  if (cov) {
+    counts.build(root);
+  }
+  if (!tar) {
+    attribute(root);
+  }
+  queue.clear();
   generate(output, root, cov);
   if (cov) {
+    std::ostringstream buf;
+    coverage_json(root, buf);
+    buf << '\n';
+    json = buf.str();
     coverage(output, root);
+    asset(output / "coverage" / "coverage.json", json);
+    asset(output / "coverage" / "coverage.js", coverage_js);
+    asset(output / "coverage" / "coverage.css", coverage_css);
+  }
+  if (search) {
+    search_index.clear();
+    catalog(root, "");
+    shards = search_index.shards();
+    for (auto& [key, json] : shards) {
+      asset(output / "doxide-search" / (key + ".json"), json);
+    }
+    asset(output / "doxide-search" / "search.js", search_js);
+    asset(output / "doxide-search" / "search.css", search_css);
+  }
+  if (html) {
+    site_title = title(root);
+    site_search = search;
+    for (auto& [file, contents] : html_generator.assets()) {
+      asset(file, contents);
+    }
+  }
+  emit();
+}
+
+bool MarkdownGenerator::regenerate(const Entity& root, const bool cov,
+    const bool search, const std::string_view& only) {
+  plans.clear();
+  symbols.clear();
+  prepare(root);
+  index(output, root);
+
+  /* entities outside the subtree may not have been parsed, so are linked as
+   * recorded by the last full build */
+  for (auto& link : contributors.links()) {
+    symbols.insert(link.name, SymbolTable::Target{nullptr,
+        EntityType(link.type), output / link.page, link.anchor});
+  }
+  describe(root, output);
+  if (cov) {
+    counts.build(root);
+  }
+  queue.clear();
+  if (!select(root, "", cov, only)) {
+    return false;
+  }
+  if (html) {
+    site_title = title(root);
+    site_search = search;
+  }
+  emit();
+
+  /* the manifest is left untouched, so record the pages that no longer
+   * match it, for the next build to compare by contents instead */
+  for (auto& [file, hash] : current.files()) {
+    uint64_t old_hash;
+    if (previous.find(file, old_hash) && old_hash == hash) {
+      contributors.unmark(file);
+    } else {
+      contributors.mark(file);
+    }
+  }
+  contributors.save();
+  return true;
+}
+
+void MarkdownGenerator::emit() {
+  /* where two entities map to the same file, the last wins, as if written
+   * in sequence */
+  std::unordered_set<std::filesystem::path> seen;
+  std::vector<const Page*> todo;
+  for (auto iter = queue.rbegin(); iter != queue.rend(); ++iter) {
+    if (seen.insert(iter->file).second) {
+      todo.push_back(&*iter);
+    }
+  }
+  std::reverse(todo.begin(), todo.end());
+
+  if (tar) {
+    /* render concurrently, in batches, then append to the archive in
+     * order, so that memory use is bounded by the size of a batch */
+    WorkerPool pool;
+    const std::size_t batch = 256*pool.size();
+    std::vector<std::string> contents;
+    for (std::size_t from = 0; from < todo.size(); from += batch) {
+      std::size_t n = std::min(batch, todo.size() - from);
+      contents.assign(n, std::string());
+      pool.run(n, [&](std::size_t i) {
+        contents[i] = render(*todo[from + i]);
+      });
+      for (std::size_t i = 0; i < n; ++i) {
+        std::filesystem::path file = target(todo[from + i]->file);
+        tar->add(file.lexically_relative(output).generic_string(),
+            contents[i]);
+        current.insert(file, Manifest::hash(contents[i]));
+      }
+      nchanged += n;
+    }
+    return;
+  }
+
+  /* create directories beforehand, in order, rather than concurrently */
+  std::set<std::filesystem::path> dirs;
+  for (auto p : todo) {
+    std::filesystem::path file = target(p->file);
+    if (file.has_parent_path()) {
+      dirs.insert(file.parent_path());
+    }
+  }
+  for (auto& dir : dirs) {
+    std::filesystem::create_directories(dir);
+  }
+
+  /* render pages concurrently; each depends only on the entity tree,
+   * symbol table and coverage index, which are now read only; completed
+   * pages are handed to the write queue, so that rendering continues while
+   * earlier pages are written */
+  std::vector<uint64_t> hashes(todo.size());
+  std::vector<char> changed(todo.size());
+  WriteQueue writes;
+  WorkerPool pool;
+  pool.run(todo.size(), [&](std::size_t i) {
+    std::string contents = render(*todo[i]);
+    hashes[i] = Manifest::hash(contents);
+    writes.push([this, &changed, i, file = target(todo[i]->file),
+        contents = std::move(contents), hash = hashes[i]]() {
+      changed[i] = write(file, contents, hash);
+    });
+  });
+  writes.wait();
+
+  /* merge results in order */
+  for (std::size_t i = 0; i < todo.size(); ++i) {
+    current.insert(target(todo[i]->file), hashes[i]);
+    nchanged += changed[i];
+  }
+}
+
+std::string MarkdownGenerator::render(const Page& p) const {
+  std::ostringstream out;
+  if (!p.asset.empty()) {
+    return std::string(p.asset);
+  } else {
+    page(p, out);
+  }
+  if (html) {
+    return html_generator.page(p.file, out.str(), site_title, site_search);
+  } else {
+    return out.str();
   }
 }
 
 void MarkdownGenerator::clean() {
-  if (std::filesystem::exists(output) && std::filesystem::is_directory(output)) {
-    for (auto& entry : std::filesystem::recursive_directory_iterator(output)) {
-      if (entry.is_regular_file() && entry.path().extension() == ".md" &&
-          !files.contains(entry)) {
-        try {
-          YAMLParser parser;
-          YAMLNode frontmatter = parser.parse(entry.path().string());
-          if (frontmatter.isValue("generator") &&
-              frontmatter.value("generator") == "doxide") {
-            std::filesystem::remove(entry.path());
-          }
-        } catch (const std::runtime_error& e) {
-          warn(e.what());
-        }
+  if (tar) {
+    /* the archive holds the pages of this build only, so there is nothing
+     * to remove, just the archive to finish */
+    tar->close();
+    return;
+  }
+  std::vector<std::filesystem::path> removed;
+  if (has_previous) {
+    for (auto& [file, hash] : previous.files()) {
+      if (!current.contains(file)) {
+        removed.push_back(file);
       }
     }
 
-    /* traverse the output directory again, this time removing any empty
-     * directories; because removing a directory may make its parent directory
-     * empty, repeat until there are no further empty directories */
-    std::vector<std::filesystem::path> empty;
-    do {
-      empty.clear();
-      for (auto& entry : std::filesystem::recursive_directory_iterator(output)) {
-        if (entry.is_directory() && std::filesystem::is_empty(entry.path())) {
-          empty.push_back(entry.path());
-        }
+    /* pages written by partial builds since, which may be new */
+    for (auto& file : contributors.marked()) {
+      if (!current.contains(file) && !previous.contains(file) &&
+          std::filesystem::exists(file)) {
+        removed.push_back(file);
       }
-      for (auto& dir : empty) {
-        std::filesystem::remove(dir);
+    }
+  } else if (std::filesystem::exists(output) &&
+      std::filesystem::is_directory(output)) {
+    /* no manifest, e.g. output from an older version, so traverse the
+     * output directory instead */
+    for (auto& entry : std::filesystem::recursive_directory_iterator(output)) {
+      if (entry.is_regular_file() && (entry.path().extension() == ".md" ||
+          entry.path().extension() == ".html") &&
+          !current.contains(entry.path()) && sniff(entry.path())) {
+        removed.push_back(entry.path());
       }
-    } while (empty.size());
+    }
+  }
+
+  /* removing a file may leave its directory empty, and removing that
+   * directory may leave its parent empty, and so on; files listed by the
+   * manifest or contributor map are removed only if still within the output
+   * directory, should either have been edited by hand */
+  for (auto& file : removed) {
+    if (!within(file)) {
+      warn("not removing " << file.string() << ", outside of output " <<
+          "directory " << output.string());
+      continue;
+    }
+    std::error_code ec;
+    std::filesystem::remove(file, ec);
+    if (ec) {
+      warn("could not remove " << file.string() << ": " << ec.message());
+    }
+    prune(file.parent_path());
+  }
+
+  if (has_previous || current.size() > 0) {
+    current.save();
   }
+
+  /* the manifest now matches the output, and the contributor map the
+   * manifest, or there is no output left to map */
+  contributors.unmark();
+  if (current.size() == 0) {
+    contributors.clear();
+  }
+  contributors.save();
 }
 
 void MarkdownGenerator::generate(const std::filesystem::path& output,
     const Entity& entity, const bool cov) {
-  std::string name = sanitize(entity.name);  // entity name, empty for root
+  const std::string& name = plan(entity).name;  // entity name, empty for root
   std::string dirname;   // directory name for this entity
   std::string filename;  // file name for this entity
   std::string childdir;  // directory name for children, relative to filename
@@ -89,663 +1122,1144 @@ void MarkdownGenerator::generate(const std::filesystem::path& output,
     filename = name;
     childdir = name + "/";
   } else {
-    /* ...whereas namespaces and groups tend to have simpler names not
-     * affected by the mkdocs changes, while two links in the menu is a
-     * more unsightly, so don't change them */
+    /* ...whereas namespaces and groups tend to have simpler names not
+     * affected by the mkdocs changes, while two links in the menu is a
+     * more unsightly, so don't change them */
+    dirname = name;
+    filename = "index";
+    childdir = "";
+  }
+
+  std::filesystem::path file = output / dirname / (filename + ".md");
+  if (can_write(file)) {
+    queue.push_back(Page{file, &entity, childdir, cov, false});
+  }
+  auto& parts = plan(entity).parts;
+  for (int k = 0; k < int(parts.size()); ++k) {
+    if (can_write(parts[k].page)) {
+      queue.push_back(Page{parts[k].page, &entity, childdir, cov, false, {},
+          k});
+    }
+  }
+
+  /* child pages */
+  for (auto& child : view(entity, &Entity::groups, false)) {
+    generate(output / name, *child, cov);
+  }
+  for (auto& child : view(entity, &Entity::namespaces, false)) {
+    generate(output / name, *child, cov);
+  }
+  for (auto& child : view(entity, &Entity::types, false)) {
+    generate(output / name, *child, cov);
+  }
+}
+
+void MarkdownGenerator::index(const std::filesystem::path& output,
+    const Entity& entity) {
+  /* must follow the same layout as generate() */
+  Plan& p = plans.at(&entity);
+  const std::string& name = p.name;
+  if (entity.type == EntityType::ROOT) {
+    p.page = output / "index.md";
+  } else if (entity.type == EntityType::TYPE) {
+    p.page = output / (name + ".md");
+  } else {
+    p.page = output / name / "index.md";
+  }
+  symbols.insert(entity, p.page, "");
+  split(entity);
+
+  /* members documented on the same page, or its parts; enumerators have no
+   * anchor of their own */
+  for (auto list : {&Entity::typedefs, &Entity::concepts, &Entity::macros,
+      &Entity::variables, &Entity::operators, &Entity::functions}) {
+    for (auto& child : view(entity, list, false)) {
+      symbols.insert(*child, member_page(entity, *child), plan(*child).name);
+    }
+  }
+  for (auto& child : view(entity, &Entity::enums, false)) {
+    symbols.insert(*child, p.page, "");
+  }
+
+  /* child pages */
+  for (auto& child : view(entity, &Entity::groups, false)) {
+    index(output / name, *child);
+  }
+  for (auto& child : view(entity, &Entity::namespaces, false)) {
+    index(output / name, *child);
+  }
+  for (auto& child : view(entity, &Entity::types, false)) {
+    index(output / name, *child);
+  }
+}
+
+void MarkdownGenerator::catalog(const Entity& entity,
+    const std::string& scope) {
+  /* must follow the same layout as index(); groups do not qualify names */
+  const std::string page = url(plan(entity).page);
+  const char* kind = search_kinds[int(entity.type)];
+  std::string qualified = qualifier(entity, scope);
+  if (entity.type == EntityType::GROUP) {
+    search_index.insert(entity.name.view(), entity.name.view(), kind, page,
+        plan(entity).brief);
+  } else if (entity.type != EntityType::ROOT) {
+    qualified += entity.name.view();
+    search_index.insert(entity.name.view(), qualified, kind, page,
+        plan(entity).brief);
+    qualified += "::";
+  }
+
+  /* members documented on the same page, or its parts; enumerators have no
+   * anchor of their own, and macros are not scoped */
+  for (auto list : {&Entity::typedefs, &Entity::concepts, &Entity::macros,
+      &Entity::variables, &Entity::operators, &Entity::functions,
+      &Entity::enums}) {
+    for (auto& child : view(entity, list, false)) {
+      std::string anchor = (list == &Entity::enums) ? "" :
+          "#" + plan(*child).name;
+      std::string name = (list == &Entity::macros) ? child->name.str() :
+          qualifier(*child, qualified) + child->name.str();
+      search_index.insert(child->name.view(), name,
+          search_kinds[int(child->type)],
+          url(member_page(entity, *child)) + anchor, plan(*child).brief);
+    }
+  }
+
+  /* child pages */
+  for (auto& child : view(entity, &Entity::groups, false)) {
+    catalog(*child, scope);
+  }
+  for (auto& child : view(entity, &Entity::namespaces, false)) {
+    catalog(*child, qualified);
+  }
+  for (auto& child : view(entity, &Entity::types, false)) {
+    catalog(*child, qualified);
+  }
+}
+
+void MarkdownGenerator::split(const Entity& entity) {
+  Plan& p = plans.at(&entity);
+  p.parts.clear();
+
+  /* members with details on the page, and their estimated size */
+  std::vector<const Entity*> members;
+  std::size_t bytes = 0;
+  for (auto list : {&Entity::typedefs, &Entity::concepts, &Entity::macros,
+      &Entity::variables, &Entity::operators, &Entity::functions}) {
+    for (auto& child : view(entity, list, true)) {
+      members.push_back(child);
+      bytes += estimate(*child);
+    }
+  }
+  auto over = [&](const std::size_t n, const std::size_t b) {
+    return (split_members > 0 && n > split_members) ||
+        (split_bytes > 0 && b > split_bytes);
+  };
+  if (!over(members.size(), bytes)) {
+    return;
+  }
+
+  /* file by initial letter, then name; the sort is stable, so that members
+   * of the same name keep the order of their lists */
+  std::stable_sort(members.begin(), members.end(),
+      [](const Entity* a, const Entity* b) {
+        char x = initial(a->name.view()), y = initial(b->name.view());
+        return x < y || (x == y && a->name < b->name);
+      });
+
+  /* one part per letter, or more if that is still too large; members of
+   * the same name, such as overloads, stay together, as only the first has
+   * an anchor */
+  std::string prefix = p.page.filename() == "index.md" ? "members-" :
+      p.page.stem().string() + "-members-";
+  char letter = 0;
+  int number = 0;
+  std::size_t n = 0, b = 0;
+  for (std::size_t i = 0; i < members.size();) {
+    std::size_t j = i, size = 0;
+    for (; j < members.size() && members[j]->name == members[i]->name; ++j) {
+      size += estimate(*members[j]);
+    }
+    char c = initial(members[i]->name.view());
+    if (c != letter || (n > 0 && over(n + j - i, b + size))) {
+      number = (c != letter) ? 1 : number + 1;
+      letter = c;
+      std::string key(1, c);
+      std::string title(1, char(std::toupper(c)));
+      if (number > 1) {
+        key += "-" + std::to_string(number);
+        title += " (" + std::to_string(number) + ")";
+      }
+      p.parts.push_back(Part{p.page.parent_path() / (prefix + key + ".md"),
+          title});
+      n = 0;
+      b = 0;
+    }
+    n += j - i;
+    b += size;
+    for (; i < j; ++i) {
+      plans.at(members[i]).part = int(p.parts.size()) - 1;
+    }
+  }
+}
+
+const std::filesystem::path& MarkdownGenerator::member_page(
+    const Entity& parent, const Entity& child) const {
+  int k = plan(child).part;
+  return k < 0 ? plan(parent).page : plan(parent).parts[k].page;
+}
+
+std::string MarkdownGenerator::href(const Entity& parent,
+    const Entity& child) const {
+  int k = plan(child).part;
+  if (k < 0) {
+    return "#" + plan(child).name;
+  } else {
+    return plan(parent).parts[k].page.filename().string() + "#" +
+        plan(child).name;
+  }
+}
+
+void MarkdownGenerator::attribute(const Entity& root) {
+  contributors.clear();
+  std::unordered_map<const Entity*,std::vector<std::size_t>> sources;
+  contributions(root, sources);
+  subtrees(root, "", sources);
+
+  /* targets of cross-references, sorted by name, so that the map is
+   * identical for identical output */
+  using entry_type = std::pair<const std::string,SymbolTable::Target>;
+  std::vector<const entry_type*> entries;
+  entries.reserve(symbols.entries().size());
+  for (auto& entry : symbols.entries()) {
+    entries.push_back(&entry);
+  }
+  std::sort(entries.begin(), entries.end(),
+      [](const entry_type* a, const entry_type* b) {
+        return a->first < b->first;
+      });
+  for (auto entry : entries) {
+    auto& target = entry->second;
+    contributors.link(entry->first, int(target.type), target.page,
+        target.anchor);
+  }
+}
+
+void MarkdownGenerator::contributions(const Entity& entity,
+    std::unordered_map<const Entity*,std::vector<std::size_t>>& sources) {
+  for (auto& dir : entity.dirs) {
+    contributions(dir, sources);
+  }
+  for (auto& file : entity.files) {
+    /* files are visited once each, in order, so the indices recorded for
+     * each entity are sorted and unique; an ancestor that already has the
+     * index of this file has it for all of its own ancestors too */
+    std::size_t i = contributors.source(file.path.string());
+    for (auto& iter : file.path.contributions()) {
+      for (const Entity* e = &*iter; e; e = e->parent) {
+        if (e->type == EntityType::NAMESPACE ||
+            e->type == EntityType::GROUP ||
+            e->type == EntityType::TYPE) {
+          auto& s = sources[e];
+          if (!s.empty() && s.back() == i) {
+            break;
+          }
+          s.push_back(i);
+        }
+      }
+    }
+  }
+}
+
+void MarkdownGenerator::subtrees(const Entity& entity,
+    const std::string& scope,
+    std::unordered_map<const Entity*,std::vector<std::size_t>>& sources) {
+  /* must follow the same naming as catalog() */
+  std::string qualified = qualifier(entity, scope);
+  if (entity.type == EntityType::GROUP) {
+    contributors.subtree(plan(entity).page, entity.name.str(),
+        std::move(sources[&entity]));
+  } else if (entity.type != EntityType::ROOT) {
+    qualified += entity.name.view();
+    contributors.subtree(plan(entity).page, qualified,
+        std::move(sources[&entity]));
+    qualified += "::";
+  }
+  for (auto& child : view(entity, &Entity::groups, false)) {
+    subtrees(*child, scope, sources);
+  }
+  for (auto& child : view(entity, &Entity::namespaces, false)) {
+    subtrees(*child, qualified, sources);
+  }
+  for (auto& child : view(entity, &Entity::types, false)) {
+    subtrees(*child, qualified, sources);
+  }
+}
+
+bool MarkdownGenerator::select(const Entity& entity, const std::string& scope,
+    const bool cov, const std::string_view& only) {
+  /* must follow the same naming as subtrees() */
+  std::string qualified = qualifier(entity, scope);
+  std::string name;
+  if (entity.type == EntityType::GROUP) {
+    name = entity.name.str();
+  } else if (entity.type != EntityType::ROOT) {
+    qualified += entity.name.view();
+    name = qualified;
+    qualified += "::";
+  }
+  if (entity.type != EntityType::ROOT &&
+      contributors.matches(plan(entity).page, name, only)) {
+    /* the directory passed to generate() is that of the parent, from
+     * which it derives the page, as in index() */
+    const std::filesystem::path& page = plan(entity).page;
+    generate(entity.type == EntityType::TYPE ? page.parent_path() :
+        page.parent_path().parent_path(), entity, cov);
+    return true;
+  }
+
+  bool found = false;
+  for (auto& child : view(entity, &Entity::groups, false)) {
+    found = select(*child, scope, cov, only) || found;
+  }
+  for (auto& child : view(entity, &Entity::namespaces, false)) {
+    found = select(*child, qualified, cov, only) || found;
+  }
+  for (auto& child : view(entity, &Entity::types, false)) {
+    found = select(*child, qualified, cov, only) || found;
+  }
+  return found;
+}
+
+std::string MarkdownGenerator::url(const std::filesystem::path& page) const {
+  /* as for mkdocs with directory URLs, e.g. ns/index.md at ns/ and
+   * ns/Type.md at ns/Type/ */
+  std::string rel = page.lexically_relative(output).generic_string();
+  if (page.filename() == "index.md") {
+    rel.resize(rel.size() - 8);
+  } else {
+    rel.resize(rel.size() - 3);
+    rel += '/';
+  }
+  return rel;
+}
+
+void MarkdownGenerator::prepare(const Entity& entity) {
+  Plan& p = plans[&entity];
+  p.name = sanitize(entity.name);
+
+  /* visible children, list by list, then a copy sorted within each list;
+   * the sort is stable, so that entities of the same name keep their
+   * declaration order */
+  auto hide = [](const Entity& e) {
+    return !e.visible || e.hide;
+  };
+  auto compare = [](const Entity* a, const Entity* b) {
+    return a->name < b->name;
+  };
+  for (std::size_t i = 0; i < std::size(Entity::lists); ++i) {
+    p.offsets[i] = p.declared.size();
+    for (auto& child : entity.*Entity::lists[i]) {
+      if (!hide(child)) {
+        p.declared.push_back(&child);
+      }
+    }
+  }
+  p.offsets.back() = p.declared.size();
+  p.sorted = p.declared;
+  for (std::size_t i = 0; i < std::size(Entity::lists); ++i) {
+    std::stable_sort(p.sorted.begin() + p.offsets[i],
+        p.sorted.begin() + p.offsets[i + 1], compare);
+  }
+
+  for (auto child : p.declared) {
+    prepare(*child);
+  }
+}
+
+void MarkdownGenerator::describe(const Entity& entity,
+    const std::filesystem::path& dir) {
+  /* the brief description appears on the page of the parent, as does the
+   * declaration, except for a type, which has its own page */
+  Plan& p = plans.at(&entity);
+  std::filesystem::path own = p.page.empty() ? dir : p.page.parent_path();
+  p.brief = symbols.resolve(line(brief(entity)), entity, dir);
+  p.decl = decl(entity, entity.type == EntityType::TYPE ? own : dir);
+  for (auto list : Entity::lists) {
+    if (list != &Entity::dirs && list != &Entity::files) {
+      for (auto& child : view(entity, list, false)) {
+        describe(*child, own);
+      }
+    }
+  }
+}
+
+void MarkdownGenerator::coverage(const std::filesystem::path& output,
+    const Entity& entity) {
+  std::string name = sanitize(entity.type == EntityType::ROOT ?
+      "coverage" : entity.name);  // entity name, "coverage"" for root
+  std::string dirname;  // directory name for this entity
+  std::string filename;  // file name for this entity
+  std::string childdir;  // directory name for children, relative to filename
+  if (entity.type == EntityType::FILE) {
+    /* as for types in generate(), working around some mkdocs behavior */
+    dirname = "";
+    filename = name;
+    childdir = name + "/";
+  } else {
     dirname = name;
     filename = "index";
     childdir = "";
   }
 
-  std::filesystem::create_directories(output / dirname);
   std::filesystem::path file = output / dirname / (filename + ".md");
   if (can_write(file)) {
-    files.insert(file);
-    std::ofstream out(file);
+    queue.push_back(Page{file, &entity, childdir, false, true});
+  }
+
+  /* child pages */
+  for (auto& child : view(entity, &Entity::dirs, false)) {
+    coverage(output / name, *child);
+  }
+  for (auto& child : view(entity, &Entity::files, false)) {
+    coverage(output / name, *child);
+  }
+}
+
+void MarkdownGenerator::asset(const std::filesystem::path& file,
+    const std::string_view& contents) {
+  if (can_write(file)) {
+    queue.push_back(Page{file, nullptr, "", false, false, contents});
+  }
+}
+
+std::string MarkdownGenerator::coverage_base(
+    const std::filesystem::path& file) const {
+  /* pages are served at directory URLs, e.g. coverage/src/index.md at
+   * coverage/src/ and coverage/src/main.cpp.md at coverage/src/main.cpp/, so
+   * the depth below the coverage directory is one less for an index page */
+  std::filesystem::path rel = file.lexically_relative(output / "coverage");
+  auto depth = std::distance(rel.begin(), rel.end());
+  if (rel.filename() == "index.md") {
+    --depth;
+  }
+  std::string base;
+  for (; depth > 0; --depth) {
+    base += "../";
+  }
+  return base;
+}
+
+void MarkdownGenerator::page(const Page& p, std::ostream& out) const {
+  /* frontmatter, whatever the template, so that the page is recognized as
+   * generated by Doxide */
+  out << frontmatter(*p.entity) << '\n';
 
-    /* frontmatter*/
-    out << frontmatter(entity) << std::endl;
+  for (auto& instruction : layout(p).instructions()) {
+    field(p, instruction, out);
+  }
+}
 
-    /* header */
-    out << "# " << title(entity) << std::endl;
-    out << std::endl;
-    if (entity.type == EntityType::TYPE) {
-      out << "**" << htmlize(line(entity.decl)) << "**" << std::endl;
-      out << std::endl;
+const PageTemplate& MarkdownGenerator::layout(const Page& p) const {
+  const Entity& entity = *p.entity;
+  if (p.report) {
+    if (entity.type == EntityType::ROOT) {
+      return templates[TEMPLATE_COVERAGE_ROOT];
+    } else if (entity.type == EntityType::FILE) {
+      return templates[TEMPLATE_COVERAGE_FILE];
+    } else {
+      return templates[TEMPLATE_COVERAGE_DIR];
     }
-    out << entity.docs << std::endl;
-    out << std::endl;
+  } else if (p.part >= 0) {
+    return templates[TEMPLATE_PART];
+  } else if (entity.type == EntityType::ROOT) {
+    return templates[TEMPLATE_ROOT];
+  } else if (entity.type == EntityType::GROUP) {
+    return templates[TEMPLATE_GROUP];
+  } else if (entity.type == EntityType::TYPE) {
+    return templates[TEMPLATE_TYPE];
+  } else {
+    return templates[TEMPLATE_NAMESPACE];
+  }
+}
 
-    /* groups */
-    for (auto& child : view(entity.groups, false)) {
+void MarkdownGenerator::field(const Page& p,
+    const PageTemplate::Instruction& instruction, std::ostream& out) const {
+  using Field = PageTemplate::Field;
+  const Entity& entity = *p.entity;
+  const std::string& childdir = p.childdir;
+  const bool cov = p.cov;
+  std::filesystem::path dir = p.file.parent_path();
+
+  switch (instruction.field) {
+  case Field::TEXT:
+    out << instruction.text;
+    break;
+  case Field::TITLE:
+    out << title(entity);
+    break;
+  case Field::NAME:
+    out << entity.name;
+    break;
+  case Field::DECL:
+    out << plan(entity).decl;
+    break;
+  case Field::BRIEF:
+    /* the brief description in the plan is resolved for the page of the
+     * parent, which may be in another directory */
+    out << symbols.resolve(line(brief(entity)), entity, dir);
+    break;
+  case Field::PART:
+    if (p.part >= 0) {
+      out << plan(entity).parts[p.part].title;
+    }
+    break;
+  case Field::DOCS:
+    out << symbols.resolve(entity.docs, entity, dir) << '\n';
+    out << '\n';
+    break;
+  case Field::GROUPS:
+    for (auto& child : view(entity, &Entity::groups, false)) {
       out << ":material-format-section: [" << title(*child) << ']';
-      out << "(" << childdir << sanitize(child->name) << "/index.md)" << std::endl;
-      out << ":   " << line(brief(*child)) << std::endl;
-      out << std::endl;
+      out << "(" << childdir << plan(*child).name << "/index.md)";
+      if (cov) {
+        out << " (" << percent(counts.get(*child)) << " coverage)";
+      }
+      out << '\n';
+      out << ":   " << plan(*child).brief << '\n';
+      out << '\n';
     }
-
-    /* namespaces */
-    for (auto& child : view(entity.namespaces, true)) {
+    break;
+  case Field::NAMESPACES:
+    for (auto& child : view(entity, &Entity::namespaces, true)) {
       out << ":material-package: [" << child->name << ']';
-      out << "(" << childdir << sanitize(child->name) << "/index.md)" << std::endl;
-      out << ":   " << line(brief(*child)) << std::endl;
-      out << std::endl;
+      out << "(" << childdir << plan(*child).name << "/index.md)";
+      if (cov) {
+        out << " (" << percent(counts.get(*child)) << " coverage)";
+      }
+      out << '\n';
+      out << ":   " << plan(*child).brief << '\n';
+      out << '\n';
     }
-
-    /* code coverage */
+    break;
+  case Field::COVERAGE:
     if (entity.type == EntityType::ROOT && cov) {
-      out << ":material-chart-pie: [Code Coverage](coverage/index.md)" << std::endl;
-      out << std::endl;
-    }
-
-    /* brief descriptions */
-    auto types = view(entity.types,
-        entity.type == EntityType::NAMESPACE ||
-        entity.type == EntityType::GROUP);
-    if (types.size() > 0) {
-      out << "## Types" << std::endl;
-      out << std::endl;
-      out << "| Name | Description |" << std::endl;
-      out << "| ---- | ----------- |" << std::endl;
-      for (auto& child : types) {
-        out << "| [" << child->name << "](" << childdir << sanitize(child->name) << ".md) | ";
-        out << line(brief(*child)) << " |" << std::endl;
-      }
-      out << std::endl;
-    }
-
-    auto typedefs = view(entity.typedefs,
-        entity.type == EntityType::NAMESPACE ||
-        entity.type == EntityType::GROUP);
-    if (typedefs.size() > 0) {
-      out << "## Type Aliases" << std::endl;
-      out << std::endl;
-      out << "| Name | Description |" << std::endl;
-      out << "| ---- | ----------- |" << std::endl;
-      for (auto& child : typedefs) {
-        out << "| [" << child->name << "](#" << sanitize(child->name) << ") | ";
-        out << line(brief(*child)) << " |" << std::endl;
-      }
-      out << std::endl;
-    }
-
-    auto concepts = view(entity.concepts,
-        entity.type == EntityType::NAMESPACE ||
-        entity.type == EntityType::GROUP);
-    if (concepts.size() > 0) {
-      out << "## Concepts" << std::endl;
-      out << std::endl;
-      out << "| Name | Description |" << std::endl;
-      out << "| ---- | ----------- |" << std::endl;
-      for (auto& child : concepts) {
-        out << "| [" << child->name << "](#" << sanitize(child->name) << ") | ";
-        out << line(brief(*child)) << " |" << std::endl;
-      }
-      out << std::endl;
-    }
-
-    auto macros = view(entity.macros,
-        entity.type == EntityType::NAMESPACE ||
-        entity.type == EntityType::GROUP);
-    if (macros.size() > 0) {
-      out << "## Macros" << std::endl;
-      out << std::endl;
-      out << "| Name | Description |" << std::endl;
-      out << "| ---- | ----------- |" << std::endl;
-      for (auto& child : macros) {
-        out << "| [" << child->name << "](#" << sanitize(child->name) << ") | ";
-        out << line(brief(*child)) << " |" << std::endl;
-      }
-      out << std::endl;
-    }
-
-    auto variables = view(entity.variables,
-        entity.type == EntityType::NAMESPACE ||
-        entity.type == EntityType::GROUP);
-    if (variables.size() > 0) {
-      out << "## Variables" << std::endl;
-      out << std::endl;
-      out << "| Name | Description |" << std::endl;
-      out << "| ---- | ----------- |" << std::endl;
-      for (auto& child : variables) {
-        out << "| [" << child->name << "](#" << sanitize(child->name) << ") | ";
-        out << line(brief(*child)) << " |" << std::endl;
-      }
-      out << std::endl;
-    }
-
-    auto operators = view(entity.operators,
-          entity.type == EntityType::NAMESPACE ||
-          entity.type == EntityType::GROUP);
-    if (operators.size() > 0) {
-      out << "## Operators" << std::endl;
-      out << std::endl;
-      out << "| Name | Description |" << std::endl;
-      out << "| ---- | ----------- |" << std::endl;
-      for (auto& child : operators) {
-        out << "| [" << child->name << "](#" << sanitize(child->name) << ") | ";
-        out << line(brief(*child)) << " |" << std::endl;
-      }
-      out << std::endl;
-    }
-
-    auto functions = view(entity.functions,
-          entity.type == EntityType::NAMESPACE ||
-          entity.type == EntityType::GROUP);
-    if (functions.size() > 0) {
-      out << "## Functions" << std::endl;
-      out << std::endl;
-      out << "| Name | Description |" << std::endl;
-      out << "| ---- | ----------- |" << std::endl;
-      for (auto& child : functions) {
-        out << "| [" << child->name << "](#" << sanitize(child->name) << ") | ";
-        out << line(brief(*child)) << " |" << std::endl;
-      }
-      out << std::endl;
+      out << ":material-chart-pie: [Code Coverage](coverage/index.md)" << '\n';
+      out << '\n';
     }
-
+    break;
+  case Field::TYPES:
+    summary(p, &Entity::types, "Types", out);
+    break;
+  case Field::TYPEDEFS:
+    summary(p, &Entity::typedefs, "Type Aliases", out);
+    break;
+  case Field::CONCEPTS:
+    summary(p, &Entity::concepts, "Concepts", out);
+    break;
+  case Field::MACROS:
+    summary(p, &Entity::macros, "Macros", out);
+    break;
+  case Field::VARIABLES:
+    summary(p, &Entity::variables, "Variables", out);
+    break;
+  case Field::OPERATORS:
+    summary(p, &Entity::operators, "Operators", out);
+    break;
+  case Field::FUNCTIONS:
+    summary(p, &Entity::functions, "Functions", out);
+    break;
+  case Field::ENUMERATORS: {
     /* for an enumerator, output the possible values */
-    auto enums = view(entity.enums, false);
+    auto enums = view(entity, &Entity::enums, false);
     if (enums.size() > 0) {
       for (auto& child : enums) {
-        out << "**" << child->decl << "**" << std::endl;
-        out << ":   " << child->docs << std::endl;
-        out << std::endl;
+        out << "**" << child->decl << "**" << '\n';
+        out << ":   " << symbols.resolve(child->docs, *child, dir) << '\n';
+        out << '\n';
       }
-      out << std::endl;
+      out << '\n';
     }
-
-    /* detailed descriptions */
-    typedefs = view(entity.typedefs, true);
-    if (typedefs.size() > 0) {
-      out << "## Type Alias Details" << std::endl;
-      out << std::endl;
-      for (auto& child : typedefs) {
-        out << "### " << child->name;
-        out << "<a name=\"" << sanitize(child->name) << "\"></a>" << std::endl;
-        out << std::endl;
-        out << "!!! typedef \"" << htmlize(line(child->decl)) << '"' << std::endl;
-        out << std::endl;
-        out << indent(child->docs) << std::endl;
-        out << std::endl;
+    break;
+  }
+  case Field::DETAILS:
+    /* detailed descriptions, or links to the parts of the page that hold
+     * them; parts are in the same directory as the page, so links resolve
+     * the same */
+    if (p.part >= 0 || plan(entity).parts.empty()) {
+      details(entity, p.part, dir, out);
+    } else {
+      out << "## Details" << '\n';
+      out << '\n';
+      parts(entity, out);
+    }
+    break;
+  case Field::PARTS:
+    if (!plan(entity).parts.empty()) {
+      parts(entity, out);
+    }
+    break;
+  case Field::SUNBURST:
+    if (entity.type == EntityType::ROOT || entity.type == EntityType::DIR) {
+      sunburst(entity, coverage_base(p.file), out);
+      out << '\n';
+    }
+    break;
+  case Field::TABLE:
+    if (entity.type == EntityType::ROOT || entity.type == EntityType::DIR) {
+      coverage_table(p, out);
+    }
+    break;
+  case Field::LINES:
+    if (entity.type == EntityType::FILE) {
+      coverage_lines(p, out);
+    }
+    break;
+  case Field::LISTING:
+    if (entity.type == EntityType::FILE) {
+      /* lines numbers and source code */
+      std::string_view styles = entity.path.styles(entity.decl);
+      if (styles.empty()) {
+        out << "```cpp linenums=\"1\"" << '\n';
+        out << entity.decl << '\n';
+        out << "```" << '\n';
+      } else {
+        listing(entity.decl, styles, out);
       }
+      out << '\n';
     }
+    break;
+  }
+}
 
-    concepts = view(entity.concepts, true);
-    if (concepts.size() > 0) {
-      out << "## Concept Details" << std::endl;
-      out << std::endl;
-      for (auto& child : concepts) {
-        out << "### " << child->name;
-        out << "<a name=\"" << sanitize(child->name) << "\"></a>" << std::endl;
-        out << std::endl;
-        out << "!!! concept \"" << htmlize(line(child->decl)) << '"' << std::endl;
-        out << std::endl;
-        out << indent(child->docs) << std::endl;
-        out << std::endl;
+void MarkdownGenerator::summary(const Page& p,
+    Entity::list_type Entity::* list, const char* heading,
+    std::ostream& out) const {
+  const Entity& entity = *p.entity;
+  const bool cov = p.cov;
+  auto children = view(entity, list, entity.type == EntityType::NAMESPACE ||
+      entity.type == EntityType::GROUP);
+  if (children.size() > 0) {
+    out << "## " << heading << '\n';
+    out << '\n';
+    out << (cov ? "| Name | Coverage | Description |" :
+        "| Name | Description |") << '\n';
+    out << (cov ? "| ---- | -------: | ----------- |" :
+        "| ---- | ----------- |") << '\n';
+    for (auto& child : children) {
+      /* types have their own pages, other members are on this page */
+      out << "| [" << child->name << "](";
+      if (list == &Entity::types) {
+        out << p.childdir << plan(*child).name << ".md";
+      } else {
+        out << href(entity, *child);
       }
+      out << ") | ";
+      if (cov) {
+        out << percent(counts.get(*child)) << " | ";
+      }
+      out << plan(*child).brief << " |" << '\n';
     }
+    out << '\n';
+  }
+}
 
-    macros = view(entity.macros, true);
-    if (macros.size() > 0) {
-      out << "## Macro Details" << std::endl;
-      out << std::endl;
-      for (auto& child : macros) {
-        out << "### " << child->name;
-        out << "<a name=\"" << sanitize(child->name) << "\"></a>" << std::endl;
-        out << std::endl;
-        out << "!!! macro \"" << htmlize(line(child->decl)) << '"' << std::endl;
-        out << std::endl;
-        out << indent(child->docs) << std::endl;
-        out << std::endl;
+void MarkdownGenerator::details(const Entity& entity, const int part,
+    const std::filesystem::path& dir, std::ostream& out) const {
+  /* members of the part, or all members */
+  auto select = [&](Entity::list_type Entity::* list) {
+    std::vector<const Entity*> members;
+    for (auto& child : view(entity, list, true)) {
+      if (part < 0 || plan(*child).part == part) {
+        members.push_back(child);
       }
     }
+    return members;
+  };
 
-    variables = view(entity.variables, true);
-    if (variables.size() > 0) {
-      out << "## Variable Details" << std::endl;
-      out << std::endl;
-      for (auto& child : variables) {
-        out << "### " << child->name;
-        out << "<a name=\"" << sanitize(child->name) << "\"></a>" << std::endl;
-        out << std::endl;
-        out << "!!! variable \"" << htmlize(line(child->decl)) << '"' << std::endl;
-        out << std::endl;
-        out << indent(child->docs) << std::endl;
-        out << std::endl;
-      }
-    }
-
-    operators = view(entity.operators, true);
-    if (operators.size() > 0) {
-      out << "## Operator Details" << std::endl;
-      out << std::endl;
-      std::string prev;
-      for (auto& child : operators) {
-        if (child->name != prev) {
-          /* heading only for the first overload of this name */
-          out << "### " << child->name;
-          out << "<a name=\"" << sanitize(child->name) << "\"></a>" << std::endl;
-          out << std::endl;
-        }
-        out << "!!! function \"" << htmlize(line(child->decl)) << '"' << std::endl;
-        out << std::endl;
-        out << indent(child->docs) << std::endl;
-        out << std::endl;
-        prev = child->name;
-      }
-    }
-
-    functions = view(entity.functions, true);
-    if (functions.size() > 0) {
-      out << "## Function Details" << std::endl;
-      out << std::endl;
-      std::string prev;
-      for (auto& child : functions) {
-        if (child->name != prev) {
-          /* heading only for the first overload of this name */
-          out << "### " << child->name;
-          out << "<a name=\"" << sanitize(child->name) << "\"></a>" << std::endl;
-        }
-        out << "!!! function \"" << htmlize(line(child->decl)) << '"' << std::endl;
-        out << std::endl;
-        out << indent(child->docs) << std::endl;
-        out << std::endl;
-        prev = child->name;
-      }
+  auto typedefs = select(&Entity::typedefs);
+  if (typedefs.size() > 0) {
+    out << "## Type Alias Details" << '\n';
+    out << '\n';
+    for (auto& child : typedefs) {
+      out << "### " << child->name;
+      out << "<a name=\"" << plan(*child).name << "\"></a>" << '\n';
+      out << '\n';
+      out << "!!! typedef \"" << plan(*child).decl << '"' << '\n';
+      out << '\n';
+      out << indent(symbols.resolve(child->docs, *child, dir)) << '\n';
+      out << '\n';
     }
   }
 
-  /* child pages */
-  std::filesystem::create_directories(output / name);
-  for (auto& child : view(entity.groups, false)) {
-    generate(output / name, *child, cov);
-  }
-  for (auto& child : view(entity.namespaces, false)) {
-    generate(output / name, *child, cov);
+  auto concepts = select(&Entity::concepts);
+  if (concepts.size() > 0) {
+    out << "## Concept Details" << '\n';
+    out << '\n';
+    for (auto& child : concepts) {
+      out << "### " << child->name;
+      out << "<a name=\"" << plan(*child).name << "\"></a>" << '\n';
+      out << '\n';
+      out << "!!! concept \"" << plan(*child).decl << '"' << '\n';
+      out << '\n';
+      out << indent(symbols.resolve(child->docs, *child, dir)) << '\n';
+      out << '\n';
+    }
   }
-  for (auto& child : view(entity.types, false)) {
-    generate(output / name, *child, cov);
+
+  auto macros = select(&Entity::macros);
+  if (macros.size() > 0) {
+    out << "## Macro Details" << '\n';
+    out << '\n';
+    for (auto& child : macros) {
+      out << "### " << child->name;
+      out << "<a name=\"" << plan(*child).name << "\"></a>" << '\n';
+      out << '\n';
+      out << "!!! macro \"" << plan(*child).decl << '"' << '\n';
+      out << '\n';
+      out << indent(symbols.resolve(child->docs, *child, dir)) << '\n';
+      out << '\n';
+    }
   }
-}
 
-void MarkdownGenerator::coverage(const std::filesystem::path& output,
-    const Entity& entity) {
-  std::string name = sanitize(entity.type == EntityType::ROOT ?
-      "coverage" : entity.name);  // entity name, "coverage"" for root
-  std::string dirname;  // directory name for this entity
-  std::string filename;  // file name for this entity
-  std::string childdir;  // directory name for children, relative to filename
-  if (entity.type == EntityType::FILE) {
-    /* as for types in generate(), working around some mkdocs behavior */
-    dirname = "";
-    filename = name;
-    childdir = name + "/";
-  } else {
-    dirname = name;
-    filename = "index";
-    childdir = "";
+  auto variables = select(&Entity::variables);
+  if (variables.size() > 0) {
+    out << "## Variable Details" << '\n';
+    out << '\n';
+    for (auto& child : variables) {
+      out << "### " << child->name;
+      out << "<a name=\"" << plan(*child).name << "\"></a>" << '\n';
+      out << '\n';
+      out << "!!! variable \"" << plan(*child).decl << '"' << '\n';
+      out << '\n';
+      out << indent(symbols.resolve(child->docs, *child, dir)) << '\n';
+      out << '\n';
+    }
   }
 
-  std::filesystem::create_directories(output / dirname);
-  std::filesystem::path file = output / dirname / (filename + ".md");
-  if (can_write(file)) {
-    files.insert(file);
-    std::ofstream out(file);
+  auto operators = select(&Entity::operators);
+  if (operators.size() > 0) {
+    out << "## Operator Details" << '\n';
+    out << '\n';
+    Symbol prev;
+    for (auto& child : operators) {
+      if (child->name != prev) {
+        /* heading only for the first overload of this name */
+        out << "### " << child->name;
+        out << "<a name=\"" << plan(*child).name << "\"></a>" << '\n';
+        out << '\n';
+      }
+      out << "!!! function \"" << plan(*child).decl << '"' << '\n';
+      out << '\n';
+      out << indent(symbols.resolve(child->docs, *child, dir)) << '\n';
+      out << '\n';
+      prev = child->name;
+    }
+  }
 
-    /* frontmatter*/
-    out << frontmatter(entity) << std::endl;
+  auto functions = select(&Entity::functions);
+  if (functions.size() > 0) {
+    out << "## Function Details" << '\n';
+    out << '\n';
+    Symbol prev;
+    for (auto& child : functions) {
+      if (child->name != prev) {
+        /* heading only for the first overload of this name */
+        out << "### " << child->name;
+        out << "<a name=\"" << plan(*child).name << "\"></a>" << '\n';
+      }
+      out << "!!! function \"" << plan(*child).decl << '"' << '\n';
+      out << '\n';
+      out << indent(symbols.resolve(child->docs, *child, dir)) << '\n';
+      out << '\n';
+      prev = child->name;
+    }
+  }
+}
 
-    /* header */
-    if (entity.type == EntityType::ROOT) {
-      out << "# Code Coverage" << std::endl;
-      out << std::endl;
-    } else {
-      out << "# " << title(entity) << std::endl;
-      out << std::endl;
-      out << entity.docs << std::endl;
-      out << std::endl;
+void MarkdownGenerator::parts(const Entity& entity,
+    std::ostream& out) const {
+  auto& parts = plan(entity).parts;
+  for (std::size_t k = 0; k < parts.size(); ++k) {
+    if (k > 0) {
+      out << " · ";
     }
+    out << '[' << parts[k].title << "](" <<
+        parts[k].page.filename().string() << ')';
+  }
+  out << '\n';
+  out << '\n';
+}
 
-    if (entity.type == EntityType::ROOT || entity.type == EntityType::DIR) {
-      /* code coverage chart */
-      sunburst(entity, entity, out);
-      out << std::endl;
-
-      /* code coverage table */
-      out << "<table>" << std::endl;
-      out << "<thead>" << std::endl;
-      out << "<tr>" << std::endl;
-      out << "<th style=\"text-align:left;\" data-sort-method=\"dotsep\">Name</th>" << std::endl;
-      out << "<th style=\"text-align:right;\" data-sort-method=\"number\">Lines</th>" << std::endl;
-      out << "<th style=\"text-align:right;\" data-sort-method=\"number\">Covered</th>" << std::endl;
-      out << "<th style=\"text-align:right;\" data-sort-method=\"number\">Uncovered</th>" << std::endl;
-      out << "<th style=\"text-align:right;\" data-sort-method=\"number\">Coverage</th>" << std::endl;
-      out << "</tr>" << std::endl;
-      out << "</thead>" << std::endl;
-      out << "<tbody>" << std::endl;
-      coverage_data(entity, entity, out);
-      out << "</tbody>" << std::endl;
-      out << "<tfoot>" << std::endl;
-      coverage_foot(entity, entity, out);
-      out << "</tfoot>" << std::endl;
-      out << "</table>" << std::endl;
-      out << std::endl;
-    } else if (entity.type == EntityType::FILE) {
-      /* for a file, output the whole contents; line numbers are added with
-       * the Markdown notation `linenums="1"`, which ultimately creates a HTML
-       * <table> of one row <tr>, with two cells <td>, the first holding the
-       * line numbers and the second the code; the line number cell contains
-       * a further <pre> with one empty <span></span>, then each line number
-       * in a separate <span> within it; to indicate code coverage we apply
-       * styles to those <span>, which are readily selected by number using
-       * the CSS nth-child() pseudo-class */
-      const std::string& covered_color = color(100.0);
-      const std::string& uncovered_color = color(0.0);
-
-      /* style sheet to highlight lines according to code coverage */
-      out << "<style>" << std::endl;
-      out << ".linenodiv pre span {";
-      out << "padding-left:4px;padding-right:4px";
-      out << "}" << std::endl;
-      for (uint32_t line = 0; line < entity.line_counts.size(); ++line) {
-        if (entity.line_counts[line] > 0) {
-          /* line is covered; line + 2 here to account for 0-base to 1-base
-          * conversion plus the extra empty <span></span> mentioned above */
-          out << ".linenodiv pre span:nth-child(" << (line + 2) << ") {";
-          out << "background-color: #" << covered_color << "dd;";
-          out << "color: white;";
-          out << "}" << std::endl;
-          out << ".linenodiv pre span:nth-child(" << (line + 2) << ")::before {";
-          out << "content: \"● \";";
-          out << "}" << std::endl;
-        } else if (entity.line_counts[line] == 0) {
-          /* line is uncovered; line + 2 here to account for 0-base to 1-base
-          * conversion plus the extra empty <span></span> mentioned above */
-          out << ".linenodiv pre span:nth-child(" << (line + 2) << ") {";
-          out << "background-color: #" << uncovered_color << "dd;";
-          out << "color: white;";
-          out << "}" << std::endl;
-          out << ".linenodiv pre span:nth-child(" << (line + 2) << ")::before {";
-          out << "content: \"○ \";";
-          out << "}" << std::endl;
-        }
-      }
-      out << "</style>" << std::endl;
-      out << std::endl;
+void MarkdownGenerator::coverage_table(const Page& p,
+    std::ostream& out) const {
+  const Entity& entity = *p.entity;
+  std::string base = coverage_base(p.file);
+
+  /* code coverage table */
+  out << "<link rel=\"stylesheet\" href=\"" << base << "coverage.css\">" << '\n';
+  out << "<table id=\"coverage-table\">" << '\n';
+  out << "<thead>" << '\n';
+  out << "<tr>" << '\n';
+  out << "<th style=\"text-align:left;\" data-sort-method=\"dotsep\">Name</th>" << '\n';
+  out << "<th style=\"text-align:right;\" data-sort-method=\"number\">Lines</th>" << '\n';
+  out << "<th style=\"text-align:right;\" data-sort-method=\"number\">Covered</th>" << '\n';
+  out << "<th style=\"text-align:right;\" data-sort-method=\"number\">Uncovered</th>" << '\n';
+  out << "<th style=\"text-align:right;\" data-sort-method=\"number\">Coverage</th>" << '\n';
+  out << "</tr>" << '\n';
+  out << "</thead>" << '\n';
+  out << "<tbody>" << '\n';
+  coverage_data(entity, out);
+  out << "</tbody>" << '\n';
+  out << "<tfoot>" << '\n';
+  coverage_foot(entity, out);
+  out << "</tfoot>" << '\n';
+  out << "</table>" << '\n';
+  out << '\n';
+}
 
-      /* lines numbers and source code */
-      out << "```cpp linenums=\"1\"" << std::endl;
-      out << entity.decl << std::endl;
-      out << "```" << std::endl;
-      out << std::endl;
+void MarkdownGenerator::coverage_lines(const Page& p,
+    std::ostream& out) const {
+  const Entity& entity = *p.entity;
+
+  /* for a file, output the whole contents; line numbers are added with
+   * the Markdown notation `linenums="1"`, which ultimately creates a HTML
+   * <table> of one row <tr>, with two cells <td>, the first holding the
+   * line numbers and the second the code; the line number cell contains
+   * a further <pre> with one empty <span></span>, then each line number
+   * in a separate <span> within it; to indicate code coverage, the shared
+   * script applies classes to those <span>, given the covered and
+   * uncovered lines as run-length ranges, which keeps the page small even
+   * for long files */
+  std::string covered, uncovered;
+  uint32_t n = entity.line_counts.size();
+  uint32_t first = 0;
+  int state = 0;  // 0 for excluded, 1 for covered, 2 for uncovered
+  for (uint32_t line = 0; line <= n; ++line) {
+    int s = 0;
+    if (line < n && entity.line_counts.covered(line)) {
+      s = 1;
+    } else if (line < n && entity.line_counts.included(line)) {
+      s = 2;
+    }
+    if (s != state) {
+      if (state != 0) {
+        append_range(state == 1 ? covered : uncovered, first + 1, line);
+      }
+      first = line;
+      state = s;
     }
   }
+  std::string base = coverage_base(p.file);
+  out << "<link rel=\"stylesheet\" href=\"" << base << "coverage.css\">" << '\n';
+  out << "<script src=\"" << base << "coverage.js\"></script>" << '\n';
+  out << "<div class=\"doxide-lines\" data-covered=\"" << covered <<
+      "\" data-uncovered=\"" << uncovered << "\"></div>" << '\n';
+  out << '\n';
+}
 
-  /* child pages */
-  std::filesystem::create_directories(output / name);
-  for (auto& child : view(entity.dirs, false)) {
-    coverage(output / name, *child);
+void MarkdownGenerator::listing(const std::string_view& source,
+    const std::string_view& styles, std::ostream& out) {
+  /* the same markup as Pygments produces for the Markdown notation
+   * `linenums="1"` (see coverage_lines()), but as raw HTML, so that it is not
+   * highlighted again; the whole is one HTML block, and blank lines would
+   * end it, so empty lines of code are given an empty <span> */
+  std::size_t n = source.size();
+  if (n > 0 && source[n - 1] == '\n') {
+    --n;  // no line after a final new line
   }
-  for (auto& child : view(entity.files, false)) {
-    coverage(output / name, *child);
+  std::size_t nlines = std::count(source.begin(), source.begin() + n, '\n')
+      + 1;
+  out << "<div class=\"language-cpp highlight\"><table class=\"highlighttable\"><tr><td class=\"linenos\"><div class=\"linenodiv\"><pre><span></span>";
+  for (std::size_t k = 1; k <= nlines; ++k) {
+    if (k > 1) {
+      out << '\n';
+    }
+    out << "<span class=\"normal\">" << k << "</span>";
+  }
+  out << "</pre></div></td><td class=\"code\"><div><pre><span></span><code>";
+  std::size_t from = 0;
+  for (std::size_t k = 1; k <= nlines; ++k) {
+    std::size_t to = std::min(source.find('\n', from), n);
+    std::string code = highlight(source.substr(from, to - from),
+        styles.substr(from, to - from));
+    if (k > 1) {
+      out << '\n';
+    }
+    if (std::all_of(code.begin(), code.end(), is_space)) {
+      out << "<span></span>";
+    }
+    out << code;
+    from = to + 1;
   }
+  out << "</code></pre></div></td></tr></table></div>" << '\n';
 }
 
 void MarkdownGenerator::coverage_data(const Entity& entity,
-    const Entity& root, std::ofstream& out) {
-  /* icons */
-  static std::string material_file_outline("<span class=\"twemoji\"><svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 24 24\"><path d=\"M14 2H6a2 2 0 0 0-2 2v16a2 2 0 0 0 2 2h12a2 2 0 0 0 2-2V8zm4 18H6V4h7v5h5z\"/></svg></span>");
-  static std::string material_folder("<span class=\"twemoji\"><svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 24 24\"><path d=\"M10 4H4c-1.11 0-2 .89-2 2v12a2 2 0 0 0 2 2h16a2 2 0 0 0 2-2V8a2 2 0 0 0-2-2h-8z\"/></svg></span>");
-
-  /* <tr> includes a data-parent attribute to facilitate filtering the table
-   * dynamically based on the currently-selected directory */
+    std::ostream& out) const {
+  /* only the rows for the children of the entity are rendered here; when
+   * another directory is selected in the sunburst chart, the shared script
+   * replaces them with rows produced from the shared coverage data */
 
   /* <td> includes data-sort (used by tablesort) for the names column to
    * prefix directory names with "a." and file names with "b." for the
    * purposes of sorting using the 'dotsep' sort order */
-
-  auto dirs = view(entity.dirs, true);
-  for (auto& child : dirs) {
-    std::string parent = sanitize(relative(child->path.parent_path(), root.path));
-    std::string name = sanitize(child->name);
-    uint32_t lines_included = child->lines_included;
-    uint32_t lines_covered = child->lines_covered;
-    uint32_t lines_uncovered = lines_included - lines_covered;
-    double lines_percent = (lines_included > 0) ?
-        100.0*lines_covered/lines_included : 100.0;
-    const std::string& lines_color = color(lines_percent);
-    std::string path = parent.empty() ? name : parent + '/' + name;
-    std::string style = parent.empty() ? "" : " style=\"display:none;\"";
-
-    out << "<tr id=\"" << path << "\" data-parent=\"" << parent << "\"" << style << ">" << std::endl;
-    out << "<td style=\"text-align:left;\" data-sort=\"a." << name << "\">" << material_folder << " <a href=\"" << path << "/\">" << htmlize(child->name) << "</a></td>" << std::endl;
-    out << "<td style=\"text-align:right;\">" << lines_included << "</td>" << std::endl;
-    out << "<td style=\"text-align:right;\">" << lines_covered << "</td>" << std::endl;
-    out << "<td style=\"text-align:right;\">" << lines_uncovered << "</td>" << std::endl;
-    out << "<td style=\"text-align:right;box-shadow: -8px 0 0 0 #" << lines_color << "dd inset;\">" << std::fixed << std::setprecision(1) << lines_percent << "%</td>" << std::endl;
-    out << "</tr>" << std::endl;
-
-    coverage_data(*child, root, out);
-  }
-
-  auto files = view(entity.files, true);
-  for (auto& child : files) {
-    std::string parent = sanitize(relative(child->path.parent_path(), root.path));
-    std::string name = sanitize(child->name);
-    uint32_t lines_included = child->lines_included;
-    uint32_t lines_covered = child->lines_covered;
-    uint32_t lines_uncovered = lines_included - lines_covered;
-    double lines_percent = (lines_included > 0) ?
-        100.0*lines_covered/lines_included : 100.0;
-    const std::string& lines_color = color(lines_percent);
-    std::string path = parent.empty() ? name : parent + '/' + name;
-    std::string style = parent.empty() ? "" : " style=\"display:none;\"";
-
-    out << "<tr id=\"" << path << "\" data-parent=\"" << parent << "\"" << style << ">" << std::endl;
-    out << "<td style=\"text-align:left;\" data-sort=\"b." << name << "\">" << material_file_outline << " <a href=\"" << path << "/\">" << htmlize(child->name) << "</a></td>" << std::endl;
-    out << "<td style=\"text-align:right;\">" << lines_included << "</td>" << std::endl;
-    out << "<td style=\"text-align:right;\">" << lines_covered << "</td>" << std::endl;
-    out << "<td style=\"text-align:right;\">" << lines_uncovered << "</td>" << std::endl;
-    out << "<td style=\"text-align:right;box-shadow: -8px 0 0 0 #" << lines_color << "dd inset;\">" << std::fixed << std::setprecision(1) << lines_percent << "%</td>" << std::endl;
-    out << "</tr>" << std::endl;
+  for (auto list : {&Entity::dirs, &Entity::files}) {
+    bool is_dir = list == &Entity::dirs;
+    for (auto& child : view(entity, list, true)) {
+      const std::string& name = plan(*child).name;
+      uint32_t lines_included = child->lines_included;
+      uint32_t lines_covered = child->lines_covered;
+      uint32_t lines_uncovered = lines_included - lines_covered;
+      double lines_percent = (lines_included > 0) ?
+          100.0*lines_covered/lines_included : 100.0;
+      const std::string& lines_color = color(lines_percent);
+
+      out << "<tr>" << '\n';
+      out << "<td style=\"text-align:left;\" data-sort=\"" << (is_dir ? "a." : "b.") << name << "\"><span class=\"" << (is_dir ? "doxide-folder" : "doxide-file") << "\"></span> <a href=\"" << name << "/\">" << htmlize(child->name) << "</a></td>" << '\n';
+      out << "<td style=\"text-align:right;\">" << lines_included << "</td>" << '\n';
+      out << "<td style=\"text-align:right;\">" << lines_covered << "</td>" << '\n';
+      out << "<td style=\"text-align:right;\">" << lines_uncovered << "</td>" << '\n';
+      out << "<td style=\"text-align:right;box-shadow: -8px 0 0 0 #" << lines_color << "dd inset;\">" << std::fixed << std::setprecision(1) << lines_percent << "%</td>" << '\n';
+      out << "</tr>" << '\n';
+    }
   }
 }
 
 void MarkdownGenerator::coverage_foot(const Entity& entity,
-    const Entity& root, std::ofstream& out) {
-  auto dirs = view(entity.dirs, true);
-  for (auto& child : dirs) {
-    coverage_foot(*child, root, out);
-  }
-
-  /* here data-parent is set to the name of the entity itself, not its parent,
-   * as the summary row in the footer should be shown when the entity is
-   * selected as the root */
-  std::string name = sanitize(entity.path.string());
+    std::ostream& out) const {
   uint32_t lines_included = entity.lines_included;
   uint32_t lines_covered = entity.lines_covered;
   uint32_t lines_uncovered = lines_included - lines_covered;
   double lines_percent = (lines_included > 0) ?
       100.0*lines_covered/lines_included : 100.0;
   const std::string& lines_color = color(lines_percent);
-  std::string style = (name == root.path.string()) ? "" : ", style=\"display:none;\"";
-
-  out << "<tr id=\"summary." << name << "\" data-parent=\"" << name << "\"" << style << ">" << std::endl;
-  out << "<td style=\"text-align:left;font-weight:bold;\">Summary</td>" << std::endl;
-  out << "<td style=\"text-align:right;font-weight:bold;\">" << lines_included << "</td>" << std::endl;
-  out << "<td style=\"text-align:right;font-weight:bold;\">" << lines_covered << "</td>" << std::endl;
-  out << "<td style=\"text-align:right;font-weight:bold;\">" << lines_uncovered << "</td>" << std::endl;
-  out << "<td style=\"text-align:right;font-weight:bold;box-shadow: -8px 0 0 0 #" << lines_color << "dd inset;\">" << std::fixed << std::setprecision(1) << lines_percent << "%</td>" << std::endl;
-  out << "</tr>" << std::endl;
-}
-
-void MarkdownGenerator::sunburst(const Entity& entity, const Entity& root,
-    std::ofstream& out) {
-  out <<
-  R""""(
-  <div style="position:relative;width:100%;padding-top:100%;">
-    <div id="coverage-sunburst" style="position:absolute;top:0;left:0;width:100%;height:100%;"></div>
-  </div>
-  <script src="https://cdn.jsdelivr.net/npm/echarts@5.5.1/dist/echarts.min.js"></script>
-  <script type="text/javascript">
-  )"""";
-  out << "var data = [";
-  sunburst_data(entity, root, out);
-  out << ']' << std::endl;
-  out <<
-  R""""(
-  var coverage_root = "";  // current root of coverage report
-  function update_coverage_table(params) {
-    if (typeof params.data.name === 'undefined') {
-      // occurs when the central circle is selected to go up one level
-      var path = coverage_root.substring(0, coverage_root.lastIndexOf('/'));
-      var is_dir = true;
-    } else {
-      var path = params.data.path;
-      var is_dir = params.data.type === 'dir';
-    }
-    let rows = document.querySelectorAll('[data-parent]');
-    if (is_dir) {
-      for (let row of rows) {
-        if (row.dataset.parent === path) {
-          row.style.display = '';
-        } else {
-          row.style.display = 'none';
-        }
-      }
-    } else {
-      for (let row of rows) {
-        if (row.id === path) {
-          row.style.display = '';
-        } else {
-          row.style.display = 'none';
+
+  out << "<tr>" << '\n';
+  out << "<td style=\"text-align:left;font-weight:bold;\">Summary</td>" << '\n';
+  out << "<td style=\"text-align:right;font-weight:bold;\">" << lines_included << "</td>" << '\n';
+  out << "<td style=\"text-align:right;font-weight:bold;\">" << lines_covered << "</td>" << '\n';
+  out << "<td style=\"text-align:right;font-weight:bold;\">" << lines_uncovered << "</td>" << '\n';
+  out << "<td style=\"text-align:right;font-weight:bold;box-shadow: -8px 0 0 0 #" << lines_color << "dd inset;\">" << std::fixed << std::setprecision(1) << lines_percent << "%</td>" << '\n';
+  out << "</tr>" << '\n';
+}
+
+void MarkdownGenerator::sunburst(const Entity& entity,
+    const std::string& base, std::ostream& out) const {
+  /* the chart is drawn by the shared script, from the shared coverage data,
+   * for the subtree given by data-root */
+  out << "<div style=\"position:relative;width:100%;padding-top:100%;\">" << '\n';
+  out << "<div id=\"coverage-sunburst\" data-root=\"" <<
+      htmlize(entity.path.get().generic_string()) <<
+      "\" style=\"position:absolute;top:0;left:0;width:100%;height:100%;\"></div>" << '\n';
+  out << "</div>" << '\n';
+  out << "<script src=\"https://cdn.jsdelivr.net/npm/echarts@5.5.1/dist/echarts.min.js\"></script>" << '\n';
+  out << "<script src=\"" << base << "coverage.js\"></script>" << '\n';
+}
+
+void MarkdownGenerator::coverage_json(const Entity& entity,
+    std::ostream& out) const {
+  out << "{\"name\":" << stringify(entity.name) << ',';
+  out << "\"lines\":" << entity.lines_included << ',';
+  out << "\"covered\":" << entity.lines_covered << ',';
+  out << "\"page\":" << stringify(plan(entity).name);
+  if (entity.type == EntityType::ROOT || entity.type == EntityType::DIR) {
+    out << ",\"children\":[";
+    bool first = true;
+    for (auto list : {&Entity::dirs, &Entity::files}) {
+      for (auto& child : view(entity, list, true)) {
+        if (!first) {
+          out << ',';
         }
+        first = false;
+        coverage_json(*child, out);
       }
     }
-    coverage_root = path;
+    out << ']';
   }
+  out << '}';
+}
 
-  var coverage_sunburst = echarts.init(document.getElementById('coverage-sunburst'));
-  var option = {
-    series: {
-      type: 'sunburst',
-      data: data,
-      sort: null,
-      radius: ['5%', '95%'],
-      startAngle: 0,
-      clockwise: false,
-      itemStyle: {
-        borderWidth: 1
-      },
-      label: {
-        color: 'white',
-        fontSize: 10,
-        textBorderWidth: 1,
-        align: 'center',
-        rotate: 'radial',
-        width: 80,
-        minAngle: 4,
-        overflow: 'truncate',
-        formatter: function (params) {
-          if (params.data.icon) {
-            return params.name + '\n' + params.data.icon;
-          } else {
-            return params.name;
-          }
+std::string MarkdownGenerator::decl(const Entity& entity,
+    const std::filesystem::path& dir) const {
+  /* link names of types, type aliases and concepts in the declaration to
+   * their documentation, where they can be resolved */
+  auto is_start = [](const char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+  };
+  auto is_word = [](const char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+  };
+
+  std::string str = line(entity.decl);
+  std::string_view styles = entity.path.styles(entity.decl);
+  std::string restyled = styles.empty() ? std::string() :
+      line_styles(entity.decl, styles, str);
+  auto plain = [&](const std::size_t from, const std::size_t to) {
+    std::string_view s = std::string_view(str).substr(from, to - from);
+    if (restyled.empty()) {
+      return htmlize(std::string(s));
+    } else {
+      return highlight(s, std::string_view(restyled).substr(from, to - from));
+    }
+  };
+
+  std::string r;
+  std::size_t from = 0, i = 0;
+  while (i < str.size()) {
+    if (is_start(str[i])) {
+      /* identifier, possibly qualified */
+      std::size_t j = i;
+      do {
+        if (str[j] == ':') {
+          j += 2;
         }
-      },
-      labelLayout: {
-        hideOverlap: true
-      },
-      levels: [
-        {
-          itemStyle: {
-            opacity: 0.2
-          }
+        while (j < str.size() && is_word(str[j])) {
+          ++j;
         }
-      ]
+      } while (str.compare(j, 2, "::") == 0 && j + 2 < str.size() &&
+          is_start(str[j + 2]));
+      std::string_view token(str.data() + i, j - i);
+
+      auto target = (token == entity.name.view()) ? nullptr :
+          symbols.find(token, entity);
+      if (target && target->entity != &entity &&
+          (target->type == EntityType::TYPE ||
+          target->type == EntityType::TYPEDEF ||
+          target->type == EntityType::CONCEPT)) {
+        r.append(plain(from, i));
+        r.push_back('[');
+        r.append(htmlize(std::string(token)));
+        r.append("](");
+        r.append(SymbolTable::link(*target, dir));
+        r.push_back(')');
+        from = j;
+      }
+      i = j;
+    } else if (is_word(str[i])) {
+      /* number, skip any suffix */
+      while (i < str.size() && is_word(str[i])) {
+        ++i;
+      }
+    } else {
+      ++i;
     }
-  };
-  coverage_sunburst.setOption(option);
-  coverage_sunburst.on('click', update_coverage_table);
-  window.addEventListener("resize", () => {
-    coverage_sunburst.resize();
-  });
-  </script>
-  )"""";
-}
-
-void MarkdownGenerator::sunburst_data(const Entity& entity,
-    const Entity& root, std::ofstream& out) {
-  bool first = true;
-  for (auto& dir: view(entity.dirs, true)) {
-    double percent = (dir->lines_included > 0) ?
-        100.0*dir->lines_covered/dir->lines_included : 100.0;
-    const std::string& c = color(percent);
-    const std::string& ico = icon(percent);
-    std::filesystem::path path = relative(dir->path, root.path);
-
-    if (!first) {
-      out << ", ";
-    }
-    first = false;
-
-    out << '{';
-    out << "name: \"" << dir->name << "\", ";
-    out << "path: \"" << path.string() << "\", ";
-    out << "value: " << dir->lines_included << ", ";
-    out << "type: \"dir\", ";
-    out << "icon: \"" << ico << "\", ";
-    out << "children: [";
-    sunburst_data(*dir, root, out);
-    out << "], ";
-    out << "itemStyle: { color: \"#" << c << "dd\", borderColor: \"#" << c << "\"}, ";
-    out << "label: { textBorderColor: \"#" << c << "\"}";
-    out << '}';
-  }
-  for (auto& file: view(entity.files, true)) {
-    double percent = (file->lines_included > 0) ?
-        100.0*file->lines_covered/file->lines_included : 100.0;
-    const std::string& c = color(percent);
-    const std::string& ico = icon(percent);
-    std::filesystem::path path = relative(file->path, root.path);
-
-    if (!first) {
-      out << ", ";
-    }
-    first = false;
-
-    out << '{';
-    out << "name: \"" << file->name << "\", ";
-    out << "path: \"" << path.string() << "\", ";
-    out << "value: " << file->lines_included << ", ";
-    out << "type: \"file\", ";
-    out << "icon: \"" << ico << "\", ";
-    out << "itemStyle: { color: \"#" << c << "dd\", borderColor: \"#" << c << "\"}, ";
-    out << "label: { textBorderColor: \"#" << c << "\"}";
-    out << '}';
-  }
-}
-
-bool MarkdownGenerator::can_write(const std::filesystem::path& path) {
-  bool canWrite = true;
-  if (std::filesystem::exists(path)) {
-    try {
-      YAMLParser parser;
-      YAMLNode node = parser.parse(path.string());
-      canWrite = node.isValue("generator") && node.value("generator") == "doxide";
-    } catch (const std::runtime_error& e) {
-      warn(e.what());
-      canWrite = false;
+  }
+  r.append(plain(from, str.size()));
+  return r;
+}
+
+bool MarkdownGenerator::write(const std::filesystem::path& file,
+    const std::string& contents, const uint64_t hash) const {
+  /* leave the file untouched if its contents are unchanged, so that its
+   * modification time is not updated, and tools such as mkdocs and rsync
+   * need not process it again; if the file is in the manifest, the hashes
+   * are compared, otherwise the contents */
+  std::error_code ec;
+  if (std::filesystem::file_size(file, ec) == contents.size() && !ec) {
+    uint64_t old_hash;
+    if (previous.find(file, old_hash) && !contributors.marked(file)) {
+      if (old_hash == hash) {
+        return false;
+      }
+    } else {
+      std::ifstream in(file, std::ios::binary);
+      std::string old(contents.size(), '\0');
+      if (in.read(old.data(), old.size()) && old == contents) {
+        return false;
+      }
     }
   }
+
+  std::filesystem::path tmp = file;
+  tmp += ".tmp";
+  std::ofstream out(tmp, std::ios::binary);
+  out.write(contents.data(), contents.size());
+  out.close();
+  if (!out) {
+    std::filesystem::remove(tmp, ec);
+    throw std::runtime_error("could not write " + file.string());
+  }
+  std::filesystem::rename(tmp, file);
+  return true;
+}
+
+std::filesystem::path MarkdownGenerator::target(
+    const std::filesystem::path& file) const {
+  if (html && file.extension() == ".md") {
+    return html_generator.file(file);
+  } else {
+    return file;
+  }
+}
+
+bool MarkdownGenerator::can_write(const std::filesystem::path& file) const {
+  if (tar) {
+    /* nothing is written to the output directory */
+    return true;
+  }
+  std::filesystem::path path = target(file);
+  bool canWrite = !std::filesystem::exists(path) || previous.contains(path) ||
+      sniff(path);
   if (!canWrite) {
     warn(path.string() << " already exists and was not generated by doxide, will not overwrite");
   }
   return canWrite;
 }
 
+bool MarkdownGenerator::sniff(const std::filesystem::path& path) {
+  /* frontmatter must begin on the first line; read no further than its
+   * end, and give up after a few lines, as that written by doxide is short */
+  auto trim = [](std::string_view str) {
+    auto first = str.find_first_not_of(" \t\r");
+    auto last = str.find_last_not_of(" \t\r");
+    return first == std::string_view::npos ? std::string_view() :
+        str.substr(first, last - first + 1);
+  };
+  std::ifstream in(path);
+  std::string line;
+  if (!std::getline(in, line)) {
+    return false;
+  } else if (trim(line) == "<!DOCTYPE html>") {
+    /* HTML page, with the generator meta tag in the head */
+    for (int n = 0; n < 32 && std::getline(in, line); ++n) {
+      if (trim(line) == "<meta name=\"generator\" content=\"doxide\">") {
+        return true;
+      }
+    }
+    return false;
+  } else if (trim(line) != "---") {
+    return false;
+  }
+  for (int n = 0; n < 32 && std::getline(in, line); ++n) {
+    std::string_view l = trim(line);
+    if (l == "---" || l == "...") {
+      break;
+    } else if (l.starts_with("generator:")) {
+      l = trim(l.substr(10));
+      return l == "doxide" || l == "\"doxide\"" || l == "'doxide'";
+    }
+  }
+  return false;
+}
+
+bool MarkdownGenerator::within(const std::filesystem::path& file) const {
+  std::filesystem::path rel = file.lexically_normal().lexically_relative(
+      output.lexically_normal());
+  return !rel.empty() && rel != "." && *rel.begin() != "..";
+}
+
+void MarkdownGenerator::prune(const std::filesystem::path& dir) const {
+  std::error_code ec;
+  for (auto d = dir; !d.empty() && d != output &&
+      std::filesystem::is_directory(d, ec) && std::filesystem::is_empty(d, ec);
+      d = d.parent_path()) {
+    if (!std::filesystem::remove(d, ec)) {
+      break;
+    }
+  }
+}
+
 std::string MarkdownGenerator::relative(const std::filesystem::path& path,
     const std::filesystem::path& base) {
   if (base.empty()) {
@@ -764,10 +2278,10 @@ std::string MarkdownGenerator::frontmatter(const Entity& entity) {
   /* use YAML frontmatter to ensure correct capitalization of title, and to
    * mark as managed by Doxide */
   std::stringstream buf;
-  buf << "---" << std::endl;
-  buf << "generator: doxide" << std::endl;
-  buf << "---" << std::endl;
-  buf << std::endl;
+  buf << "---" << '\n';
+  buf << "generator: doxide" << '\n';
+  buf << "---" << '\n';
+  buf << '\n';
   return buf.str();
 }
 
@@ -783,80 +2297,173 @@ std::string MarkdownGenerator::brief(const Entity& entity) {
   if (!entity.brief.empty()) {
     return entity.brief;
   } else {
-    static const std::regex reg("^(`.*?`|\\[.*?\\]\\(.*?\\)|[^;:.?!])*[\\.\\?\\!](?=\\s|$)",
-        REGEX_FLAGS);
     std::string l = line(entity.docs);
-    std::smatch match;
-    if (std::regex_search(l, match, reg)) {
-      return match.str();
-    } else {
-      return l;
+    std::vector<char> failed(l.size() + 1, false);
+    std::size_t end = sentence(l, 0, failed);
+    if (end != std::string::npos) {
+      l.resize(end);
     }
+    return l;
   }
 }
 
-std::string MarkdownGenerator::line(const std::string& str) {
-  static const std::regex newline("\\s*\\n\\s*", REGEX_FLAGS);
-  return std::regex_replace(str, newline, " ");
+std::string MarkdownGenerator::line(const std::string_view& str) {
+  /* replace each run of whitespace that contains a new line with a single
+   * space */
+  std::string r;
+  r.reserve(str.size());
+  std::size_t from = 0;
+  for (std::size_t i = find_any<'\n'>(str, 0); i < str.size();
+      i = find_any<'\n'>(str, from)) {
+    std::size_t first = i, last = i + 1;
+    while (first > from && is_space(str[first - 1])) {
+      --first;
+    }
+    while (last < str.size() && is_space(str[last])) {
+      ++last;
+    }
+    r.append(str.substr(from, first - from));
+    r.push_back(' ');
+    from = last;
+  }
+  r.append(str.substr(from));
+  return r;
 }
 
 std::string MarkdownGenerator::indent(const std::string& str) {
-  static const std::regex start("\\n", REGEX_FLAGS);
-  return "    " + std::regex_replace(str, start, "\n    ");
+  std::string r;
+  r.reserve(str.size() + 64);
+  r.append("    ");
+  std::size_t from = 0;
+  for (std::size_t i = find_any<'\n'>(str, 0); i < str.size();
+      i = find_any<'\n'>(str, from)) {
+    r.append(str, from, i - from);
+    r.append("\n    ");
+    from = i + 1;
+  }
+  r.append(str, from);
+  return r;
 }
 
 std::string MarkdownGenerator::stringify(const std::string& str) {
-  static const std::regex quote("(\"|\\\\)", REGEX_FLAGS);
   std::string r;
-  r.append("\"");
-  r.append(std::regex_replace(str, quote, "\\$1"));
-  r.append("\"");
+  r.reserve(str.size() + 2);
+  r.push_back('"');
+  std::size_t from = 0;
+  for (std::size_t i = find_any<'"','\\'>(str, 0); i < str.size();
+      i = find_any<'"','\\'>(str, from)) {
+    r.append(str, from, i - from);
+    r.push_back('\\');
+    r.push_back(str[i]);
+    from = i + 1;
+  }
+  r.append(str, from);
+  r.push_back('"');
   return r;
 }
 
 std::string MarkdownGenerator::htmlize(const std::string& str) {
-  /* basic replacements */
-  static const std::regex amp("&", REGEX_FLAGS);
-  static const std::regex lt("<", REGEX_FLAGS);
-  static const std::regex gt(">", REGEX_FLAGS);
-  static const std::regex quot("\"", REGEX_FLAGS);
-  static const std::regex apos("'", REGEX_FLAGS);
-  static const std::regex ptr("\\*", REGEX_FLAGS);
-
-  /* the sequence operator[](...) looks like a link in Markdown */
-  static const std::regex operator_brackets("operator\\[\\]", REGEX_FLAGS);
-
-  std::string r = str;
-  r = std::regex_replace(r, amp, "&amp;");  // must go first or new & replaced
-  r = std::regex_replace(r, lt, "&lt;");
-  r = std::regex_replace(r, gt, "&gt;");
-  r = std::regex_replace(r, quot, "&quot;");
-  r = std::regex_replace(r, apos, "&apos;");
-  r = std::regex_replace(r, ptr, "&#42;");
-  r = std::regex_replace(r, operator_brackets, "operator&#91;&#93;");
+  std::string r;
+  r.reserve(str.size() + str.size()/8);
+  std::size_t from = 0;
+  for (std::size_t i = find_any<'&','<','>','"','\'','*','['>(str, 0);
+      i < str.size(); i = find_any<'&','<','>','"','\'','*','['>(str, from)) {
+    r.append(str, from, i - from);
+    switch (str[i]) {
+    case '&': r.append("&amp;"); break;
+    case '<': r.append("&lt;"); break;
+    case '>': r.append("&gt;"); break;
+    case '"': r.append("&quot;"); break;
+    case '\'': r.append("&apos;"); break;
+    case '*': r.append("&#42;"); break;
+    default:
+      /* the sequence operator[](...) looks like a link in Markdown */
+      if (i >= 8 && str.compare(i - 8, 10, "operator[]") == 0) {
+        r.append("&#91;&#93;");
+        ++i;
+      } else {
+        r.push_back('[');
+      }
+    }
+    from = i + 1;
+  }
+  r.append(str, from);
   return r;
 }
 
-std::string MarkdownGenerator::sanitize(const std::string& str) {
-  static const std::regex word("\\w|[./\\\\]", REGEX_FLAGS);
-  static const std::regex space("\\s", REGEX_FLAGS);
+std::string MarkdownGenerator::highlight(const std::string_view& str,
+    const std::string_view& styles) {
+  /* as htmlize(), but square brackets are always replaced, as a run may
+   * split a sequence such as operator[] that htmlize() recognizes */
+  std::string r;
+  r.reserve(2*str.size());
+  std::size_t i = 0;
+  while (i < str.size()) {
+    Highlight style = Highlight(styles[i]);
+    const char* cls = highlight_class(style);
+    if (*cls) {
+      r.append("<span class=\"");
+      r.append(cls);
+      r.append("\">");
+    }
+    for (; i < str.size() && Highlight(styles[i]) == style; ++i) {
+      switch (str[i]) {
+      case '&': r.append("&amp;"); break;
+      case '<': r.append("&lt;"); break;
+      case '>': r.append("&gt;"); break;
+      case '"': r.append("&quot;"); break;
+      case '\'': r.append("&apos;"); break;
+      case '*': r.append("&#42;"); break;
+      case '[': r.append("&#91;"); break;
+      case ']': r.append("&#93;"); break;
+      default: r.push_back(str[i]);
+      }
+    }
+    if (*cls) {
+      r.append("</span>");
+    }
+  }
+  return r;
+}
 
-  std::stringstream buf;
-  for (auto iter = str.begin(); iter != str.end(); ++iter) {
-    if (std::regex_match(iter, iter + 1, word)) {
-      buf << *iter;
-    } else if (std::regex_match(iter, iter + 1, space)) {
-      // skip whitespace
-    } else {
-      /* encode non-word and non-space characters */
-      buf << "_u" << std::setfill('0') << std::setw(4) << std::hex << int(*iter);
+std::string MarkdownGenerator::sanitize(const std::string& str) {
+  std::string r;
+  r.reserve(str.size());
+  std::size_t from = 0;
+  for (std::size_t i = find_not_word(str, 0); i < str.size();
+      i = find_not_word(str, from)) {
+    r.append(str, from, i - from);
+    if (!is_space(str[i])) {
+      /* encode non-word and non-space characters; as for a stream with
+       * std::hex, a negative value is written as unsigned */
+      char buf[8];
+      auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf),
+          unsigned(int(str[i])), 16);
+      r.append("_u");
+      r.append(std::max(4 - (ptr - buf), std::ptrdiff_t(0)), '0');
+      r.append(buf, ptr);
     }
+    from = i + 1;
   }
+  r.append(str, from);
 
   /* on Linux and Mac, the maximum file name length is 255 bytes, plus leave
    * room for a four-character file extension (e.g. .html); on Windows it is
    * 260 bytes, so use the minimum */
-  return buf.str().substr(0, 255 - 5);
+  if (r.size() > 255 - 5) {
+    r.resize(255 - 5);
+  }
+  return r;
+}
+
+std::string MarkdownGenerator::percent(const CoverageIndex::Counts& c) {
+  if (c.included == 0) {
+    return "-";
+  } else {
+    std::stringstream buf;
+    buf << std::fixed << std::setprecision(1) << 100.0*c.covered/c.included << '%';
+    return buf.str();
+  }
 }
 
 const std::string& MarkdownGenerator::color(const double percent) {
@@ -903,24 +2510,15 @@ const std::string& MarkdownGenerator::icon(const double percent) {
   }
 }
 
-std::list<const Entity*> MarkdownGenerator::view(
-    const std::list<Entity>& entities, const bool sort) {
-  auto pointer = [](const Entity& e) {
-    return &e;
-  };
-  auto hide = [](const Entity* e) {
-    return !e->visible || e->hide;
-  };
-  auto compare = [](const Entity* a, const Entity* b) {
-    return a->name < b->name;
-  };
-
-  std::list<const Entity*> ptrs;
-  auto end = std::back_inserter(ptrs);
-  std::transform(entities.begin(), entities.end(), end, pointer);
-  ptrs.erase(std::remove_if(ptrs.begin(), ptrs.end(), hide), ptrs.end());
-  if (sort) {
-    ptrs.sort(compare);
+std::span<const Entity* const> MarkdownGenerator::view(const Entity& entity,
+    Entity::list_type Entity::* list, const bool sort) const {
+  auto& p = plan(entity);
+  auto& ptrs = sort ? p.sorted : p.declared;
+  for (std::size_t i = 0; i < std::size(Entity::lists); ++i) {
+    if (Entity::lists[i] == list) {
+      return std::span<const Entity* const>(ptrs.data() + p.offsets[i],
+          p.offsets[i + 1] - p.offsets[i]);
+    }
   }
-  return ptrs;
+  return std::span<const Entity* const>();
 }
@@ -1,12 +1,25 @@
 #pragma once
 
+#include "ContributorMap.hpp"
+#include "CoverageIndex.hpp"
 #include "Entity.hpp"
+#include "HTMLGenerator.hpp"
+#include "Manifest.hpp"
+#include "PageTemplate.hpp"
+#include "SearchIndex.hpp"
+#include "SymbolTable.hpp"
+#include "TarWriter.hpp"
 
-#include <unordered_set>
+#include <array>
 #include <filesystem>
-#include <fstream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <span>
 #include <string>
-#include <list>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 /**
  * Markdown generator.
@@ -16,31 +29,209 @@
 class MarkdownGenerator {
 public:
   /**
-   * Constructor.
+   * Constructor. Loads the manifest of files generated by the previous
+   * build, if any.
    *
    * @param output Output directory.
+   * @param html Convert pages to HTML, rather than leaving them as Markdown
+   * for MkDocs?
+   * @param split_members Maximum number of members with details on a page,
+   * or zero for no maximum.
+   * @param split_bytes Maximum size of the details of members on a page, as
+   * estimated from their declarations and documentation, or zero for no
+   * maximum.
+   * @param archive Tar archive to which to write pages, in place of the
+   * output directory, or empty to write to the output directory.
+   * @param templates Directory of page templates, or empty to use only the
+   * built-in templates (see PageTemplate).
+   *
+   * The details of members of a namespace, group or type that would exceed
+   * either maximum are split over further pages, by initial letter.
+   *
+   * When writing to an archive, file names in the archive are relative to
+   * the output directory, and the output directory itself is untouched.
    */
-  MarkdownGenerator(const std::filesystem::path& output);
+  MarkdownGenerator(const std::filesystem::path& output,
+      const bool html = false, const std::size_t split_members = 0,
+      const std::size_t split_bytes = 0,
+      const std::filesystem::path& archive = {},
+      const std::filesystem::path& templates = {});
 
   /**
    * Generate documentation.
    *
    * @param root Root entity.
    * @param cov Include code coverage report?
+   * @param search Include search index?
+   */
+  void generate(const Entity& root, const bool cov, const bool search);
+
+  /**
+   * Regenerate the documentation of one subtree only, i.e. the page of a
+   * namespace, group or type, and the pages beneath it. Other pages, the
+   * code coverage report, the search index and the manifest are left
+   * untouched, and clean() should not be called after.
+   *
+   * @param root Root entity. This need only hold the entities of the files
+   * that contribute to the subtree (see ContributorMap).
+   * @param cov Include code coverage in documentation?
+   * @param search Is a search index included, as for the last full build?
+   * @param only Subtree to regenerate, by name or page (see
+   * ContributorMap::matches()).
+   *
+   * @return True if the subtree was found, false otherwise.
    */
-  void generate(const Entity& root, const bool cov);
+  bool regenerate(const Entity& root, const bool cov, const bool search,
+      const std::string_view& only);
 
   /**
-   * Clean up after generation, removing files from old runs. Traverses the
-   * output directory, removing any Markdown files with 'generator: doxide' in
-   * their YAML frontmatter that were not generated by previous calls of
-   * `generate()`.
+   * Clean up after generation, removing files from old runs, then save the
+   * manifest and contributor map. When writing to an archive, instead
+   * finishes the archive. Removes any files in the manifest of the previous
+   * build, or written by partial builds since, that were not generated by
+   * previous calls of `generate()`. If there is no manifest, e.g. for output
+   * from an older version, instead traverses the output directory, removing
+   * any such Markdown files with 'generator: doxide' in their YAML
+   * frontmatter, or HTML pages generated by doxide. Directories left empty are removed too.
    */
   void clean();
 
+  /**
+   * Number of pages generated by calls to generate().
+   */
+  int pages() const {
+    return current.size();
+  }
+
+  /**
+   * Number of those pages that were written, because they did not exist or
+   * their contents changed. Others are left untouched. When writing to an
+   * archive, all pages are written.
+   */
+  int changed() const {
+    return nchanged;
+  }
+
 private:
   /**
-   * Recursively generate documentation.
+   * Page to render.
+   */
+  struct Page {
+    /**
+     * File name.
+     */
+    std::filesystem::path file;
+
+    /**
+     * Entity for which to render the page.
+     */
+    const Entity* entity;
+
+    /**
+     * Directory name for children, relative to the file.
+     */
+    std::string childdir;
+
+    /**
+     * Include code coverage in documentation?
+     */
+    bool cov;
+
+    /**
+     * Is this a code coverage report page, rather than a documentation page?
+     */
+    bool report;
+
+    /**
+     * Contents of a static asset, such as a script or style sheet, to write
+     * as is, or empty for a page to render.
+     */
+    std::string_view asset{};
+
+    /**
+     * Part of a split page to render, as an index into Plan::parts, or -1
+     * for the page itself.
+     */
+    int part = -1;
+  };
+
+  /**
+   * Part of a split page, holding the details of some of the members of its
+   * entity.
+   */
+  struct Part {
+    /**
+     * File name.
+     */
+    std::filesystem::path page;
+
+    /**
+     * Title, e.g. "A", or "A (2)" for the second part for the same letter.
+     */
+    std::string title;
+  };
+
+  /**
+   * Render plan for an entity. This holds everything about the entity that
+   * pages need, computed once before rendering, rather than each time the
+   * entity appears on a page.
+   */
+  struct Plan {
+    /**
+     * Name sanitized for a file name or anchor.
+     */
+    std::string name;
+
+    /**
+     * Brief description on a single line, with cross-references resolved
+     * for the page of the parent, on which it appears.
+     */
+    std::string brief;
+
+    /**
+     * Declaration on a single line, sanitized and linked for the page on
+     * which it appears.
+     */
+    std::string decl;
+
+    /**
+     * Page, for an entity that has one, otherwise empty.
+     */
+    std::filesystem::path page;
+
+    /**
+     * Parts over which the details of members are split, if the page is
+     * too large, otherwise empty.
+     */
+    std::vector<Part> parts;
+
+    /**
+     * For a member, the part of the page of its parent on which its details
+     * appear, as an index into the `parts` of the parent, or -1 if that page
+     * is not split.
+     */
+    int part = -1;
+
+    /**
+     * Visible children, list by list in the order of Entity::lists, in
+     * declaration order.
+     */
+    std::vector<const Entity*> declared;
+
+    /**
+     * As `declared`, but sorted by name within each list.
+     */
+    std::vector<const Entity*> sorted;
+
+    /**
+     * Offsets into `declared` and `sorted` at which each list begins, plus
+     * one for the end of the last.
+     */
+    std::array<uint32_t,std::size(Entity::lists) + 1> offsets;
+  };
+
+  /**
+   * Recursively enqueue documentation pages.
    *
    * @param output Output directory.
    * @param entity Entity for which to generate documentation.
@@ -50,7 +241,130 @@ private:
       const bool cov);
 
   /**
-   * Recursively generate coverage.
+   * Recursively prepare the render plans of entities, with their names and
+   * visible children.
+   *
+   * @param entity Entity.
+   */
+  void prepare(const Entity& entity);
+
+  /**
+   * Recursively complete the render plans of entities, with their brief
+   * descriptions and declarations. Requires the symbol table.
+   *
+   * @param entity Entity.
+   * @param dir Directory of the page on which the entity appears.
+   */
+  void describe(const Entity& entity, const std::filesystem::path& dir);
+
+  /**
+   * Render plan of an entity.
+   */
+  const Plan& plan(const Entity& entity) const {
+    return plans.at(&entity);
+  }
+
+  /**
+   * Recursively populate the symbol table with the pages and anchors at
+   * which entities are documented, recording pages in render plans.
+   *
+   * @param output Output directory.
+   * @param entity Entity to index.
+   */
+  void index(const std::filesystem::path& output, const Entity& entity);
+
+  /**
+   * Split the details of the members of an entity over parts, if there are
+   * too many for its page. Requires the page of the entity.
+   *
+   * @param entity Entity.
+   */
+  void split(const Entity& entity);
+
+  /**
+   * Page on which the details of a member appear: that of its parent, or,
+   * if split, the part of it that holds the member.
+   *
+   * @param parent Parent entity.
+   * @param child Member.
+   */
+  const std::filesystem::path& member_page(const Entity& parent,
+      const Entity& child) const;
+
+  /**
+   * Link to the details of a member, from the page of its parent.
+   *
+   * @param parent Parent entity.
+   * @param child Member.
+   */
+  std::string href(const Entity& parent, const Entity& child) const;
+
+  /**
+   * Recursively populate the search index with the entities documented in
+   * pages, and their members.
+   *
+   * @param entity Entity to index.
+   * @param scope Qualified name of the enclosing scope, followed by `::`, or
+   * empty for the global scope.
+   */
+  void catalog(const Entity& entity, const std::string& scope);
+
+  /**
+   * Rebuild the contributor map from the model, recording, for each entity
+   * with a page of its own, the source files that contribute to it or to
+   * the entities beneath it, and recording the targets of cross-references
+   * from the symbol table.
+   *
+   * @param root Root entity.
+   */
+  void attribute(const Entity& root);
+
+  /**
+   * Recursively attribute the contributions of source files to the entities
+   * with pages of their own that hold them, and the ancestors of those.
+   *
+   * @param entity Root entity, or a directory entity beneath it.
+   * @param[out] sources Indices of source files in the contributor map, by
+   * entity.
+   */
+  void contributions(const Entity& entity,
+      std::unordered_map<const Entity*,std::vector<std::size_t>>& sources);
+
+  /**
+   * Recursively record subtrees in the contributor map.
+   *
+   * @param entity Entity.
+   * @param scope Qualified name of the enclosing scope, followed by `::`, or
+   * empty for the global scope.
+   * @param[in,out] sources Indices of source files in the contributor map,
+   * by entity, as from contributions(); moved into the map.
+   */
+  void subtrees(const Entity& entity, const std::string& scope,
+      std::unordered_map<const Entity*,std::vector<std::size_t>>& sources);
+
+  /**
+   * Recursively enqueue the pages of the subtrees that match a target.
+   *
+   * @param entity Entity.
+   * @param scope Qualified name of the enclosing scope, followed by `::`, or
+   * empty for the global scope.
+   * @param cov Include code coverage in documentation?
+   * @param only Target.
+   *
+   * @return True if any subtree matches, false otherwise.
+   */
+  bool select(const Entity& entity, const std::string& scope, const bool cov,
+      const std::string_view& only);
+
+  /**
+   * URL of a page, relative to the output directory.
+   *
+   * @param page File name of the page.
+   */
+  std::string url(const std::filesystem::path& page) const;
+
+  /**
+   * Recursively enqueue code coverage report pages.
    *
    * @param output Output directory.
    * @param entity Entity for which to generate coverage.
@@ -58,48 +372,165 @@ private:
   void coverage(const std::filesystem::path& output, const Entity& entity);
 
   /**
-   * Recursively generate coverage table data.
+   * Enqueue a static asset.
+   *
+   * @param file File name.
+   * @param contents Contents.
+   */
+  void asset(const std::filesystem::path& file,
+      const std::string_view& contents);
+
+  /**
+   * Relative URL of the coverage directory from a code coverage report page,
+   * ending in a slash, or empty if the page is at the top of the directory.
+   *
+   * @param file File name of the page.
+   */
+  std::string coverage_base(const std::filesystem::path& file) const;
+
+  /**
+   * File to which a page is written: the page itself, or, when converting
+   * pages to HTML, the HTML page for it.
+   */
+  std::filesystem::path target(const std::filesystem::path& file) const;
+
+  /**
+   * Render and write all enqueued pages, concurrently.
+   */
+  void emit();
+
+  /**
+   * Render a page, or produce the contents of an asset.
+   *
+   * @param p Page.
+   *
+   * @return Contents of the file for the page.
+   */
+  std::string render(const Page& p) const;
+
+  /**
+   * Render a documentation or code coverage report page, according to its
+   * template.
+   *
+   * @param p Page.
+   * @param out Output stream.
+   */
+  void page(const Page& p, std::ostream& out) const;
+
+  /**
+   * Template for a page.
+   *
+   * @param p Page.
+   */
+  const PageTemplate& layout(const Page& p) const;
+
+  /**
+   * Render one instruction of the template of a page.
+   *
+   * @param p Page.
+   * @param instruction Instruction.
+   * @param out Output stream.
+   */
+  void field(const Page& p, const PageTemplate::Instruction& instruction,
+      std::ostream& out) const;
+
+  /**
+   * Render a summary table of members of one kind, with their brief
+   * descriptions, if there are any such members.
+   *
+   * @param p Page.
+   * @param list Members.
+   * @param heading Heading of the table.
+   * @param out Output stream.
+   */
+  void summary(const Page& p, Entity::list_type Entity::* list,
+      const char* heading, std::ostream& out) const;
+
+  /**
+   * Render the details of members.
+   *
+   * @param entity Entity.
+   * @param part Part of the page of the entity for which to render details,
+   * as an index into Plan::parts, or -1 for all.
+   * @param dir Directory of the page.
+   * @param out Output stream.
+   */
+  void details(const Entity& entity, const int part,
+      const std::filesystem::path& dir, std::ostream& out) const;
+
+  /**
+   * Render links to the parts of a split page.
+   *
+   * @param entity Entity.
+   * @param out Output stream.
+   */
+  void parts(const Entity& entity, std::ostream& out) const;
+
+  /**
+   * Render the code coverage table of a code coverage report page for the
+   * root or a directory.
+   *
+   * @param p Page.
+   * @param out Output stream.
+   */
+  void coverage_table(const Page& p, std::ostream& out) const;
+
+  /**
+   * Render the covered and uncovered lines of a code coverage report page
+   * for a file.
+   *
+   * @param p Page.
+   * @param out Output stream.
+   */
+  void coverage_lines(const Page& p, std::ostream& out) const;
+
+  /**
+   * Output a pre-highlighted source listing, with line numbers.
+   *
+   * @param source Source.
+   * @param styles Styles of the source, one Highlight per byte.
+   * @param out Output stream.
+   */
+  static void listing(const std::string_view& source,
+      const std::string_view& styles, std::ostream& out);
+
+  /**
+   * Generate coverage table rows for the children of an entity. Rows for
+   * other selections are produced by the shared script, on demand.
    *
    * @param entity Entity for which to generate coverage.
-   * @param root Root entity for the current page. This is used to determine
-   * which are rows should be visible initially.
    * @param out Output stream.
    */
-  static void coverage_data(const Entity& entity, const Entity& root,
-      std::ofstream& out);
+  void coverage_data(const Entity& entity, std::ostream& out) const;
 
   /**
-   * Recursively generate coverage table footer.
+   * Generate coverage table footer, summarizing an entity.
    *
    * @param entity Entity for which to generate coverage.
-   * @param root Root entity for the current page. This is used to determine
-   * which are rows should be visible initially.
    * @param out Output stream.
    */
-  static void coverage_foot(const Entity& entity, const Entity& root,
-      std::ofstream& out);
+  void coverage_foot(const Entity& entity, std::ostream& out) const;
 
   /**
-   * Produce sunburst chart of code coverage for entity.
+   * Produce sunburst chart of code coverage for entity. The chart is drawn
+   * by the shared script from the shared coverage data.
    *
    * @param entity Entity for which to generate sunburst.
-   * @param root Root entity for the current page. This is used to determine
-   * paths relative to the root.
+   * @param base Relative URL of the coverage directory, as from
+   * coverage_base().
    * @param out Output stream.
    */
-  static void sunburst(const Entity& entity, const Entity& root,
-      std::ofstream& out);
+  void sunburst(const Entity& entity, const std::string& base,
+      std::ostream& out) const;
 
   /**
-   * Produce data for sunburst chart of code coverage for entity.
+   * Recursively produce shared coverage data, as JSON, for the sunburst
+   * charts of all code coverage report pages.
    *
-   * @param entity Entity for which to generate sunburst.
-   * @param root Root entity for the current page. This is used to determine
-   * paths relative to the root.
+   * @param entity Entity for which to generate data.
    * @param out Output stream.
    */
-  static void sunburst_data(const Entity& entity, const Entity& root,
-      std::ofstream& out);
+  void coverage_json(const Entity& entity, std::ostream& out) const;
 
   /**
    * Produce a relative path.
@@ -108,10 +539,53 @@ private:
       const std::filesystem::path& base);
 
   /**
-   * Can the file be written? To be overwritten, the file must either not
-   * exist, or exists but has 'generator: doxide' in its YAML frontmatter.
+   * Produce the declaration of an entity, on a single line, sanitized for
+   * HTML, and with names of types linked to their documentation.
+   *
+   * @param entity Entity.
+   * @param dir Directory of the page on which the declaration will appear.
+   */
+  std::string decl(const Entity& entity,
+      const std::filesystem::path& dir) const;
+
+  /**
+   * Write a page, if its contents have changed. The page is written to a
+   * temporary file first then renamed, so that it is replaced atomically.
+   *
+   * @param file File name.
+   * @param contents Contents.
+   * @param hash Hash of contents.
+   *
+   * @return True if written, false if unchanged.
+   */
+  bool write(const std::filesystem::path& file, const std::string& contents,
+      const uint64_t hash) const;
+
+  /**
+   * Can the file be written? To be overwritten, the file to which it is
+   * written, as from target(), must either not exist, be in the manifest of
+   * the previous build, or be recognized by sniff().
    */
-  static bool can_write(const std::filesystem::path& path);
+  bool can_write(const std::filesystem::path& file) const;
+
+  /**
+   * Does the file have 'generator: doxide' in its YAML frontmatter, or, for
+   * an HTML page, a generator meta tag for doxide? Only the first few lines
+   * of the file are read, rather than parsing it in full.
+   */
+  static bool sniff(const std::filesystem::path& path);
+
+  /**
+   * Is a file within the output directory, by its path alone, after
+   * resolving any `.` and `..` components?
+   */
+  bool within(const std::filesystem::path& file) const;
+
+  /**
+   * Remove a directory if empty, then its parent if that is now empty, and
+   * so on up to, but excluding, the output directory.
+   */
+  void prune(const std::filesystem::path& dir) const;
 
   /**
    * Produce the YAML frontmatter for an entity.
@@ -131,7 +605,7 @@ private:
   /**
    * Reduce to a single line.
    */
-  static std::string line(const std::string& str);
+  static std::string line(const std::string_view& str);
 
   /**
    * Indent lines.
@@ -149,11 +623,27 @@ private:
    */
   static std::string htmlize(const std::string& str);
 
+  /**
+   * Sanitize for HTML as htmlize(), and wrap runs of highlighted characters
+   * in `<span>` elements with the class of their style.
+   *
+   * @param str String.
+   * @param styles Styles of the string, one Highlight per byte.
+   */
+  static std::string highlight(const std::string_view& str,
+      const std::string_view& styles);
+
   /**
    * Sanitize for a file name or internal anchor.
    */
   static std::string sanitize(const std::string& str);
 
+  /**
+   * Format line coverage as a percentage, or a dash if there are no lines
+   * included.
+   */
+  static std::string percent(const CoverageIndex::Counts& c);
+
   /**
    * Lookup color for given percentage.
    */
@@ -165,14 +655,14 @@ private:
   static const std::string& icon(const double percent);
 
   /**
-   * Convert a list of entities to a list of pointers to entities, optionally
-   * sorting by name.
+   * Visible children of an entity in one of its lists, from its render plan.
    *
-   * @param entities List of entities.
-   * @param sort Sort by name?
+   * @param entity Entity.
+   * @param list List of children, one of Entity::lists.
+   * @param sort Sorted by name? Otherwise in declaration order.
    */
-  static std::list<const Entity*> view(const std::list<Entity>& entities,
-      const bool sort);
+  std::span<const Entity* const> view(const Entity& entity,
+      Entity::list_type Entity::* list, const bool sort) const;
 
   /**
    * Output directory.
@@ -180,7 +670,106 @@ private:
   std::filesystem::path output;
 
   /**
-   * Set of files generated during the last call to generate().
+   * HTML generator, used when converting pages to HTML.
+   */
+  HTMLGenerator html_generator;
+
+  /**
+   * Title of the site, for HTML pages.
+   */
+  std::string site_title;
+
+  /**
+   * Include the search index in HTML pages?
+   */
+  bool site_search;
+
+  /**
+   * Convert pages to HTML?
+   */
+  bool html;
+
+  /**
+   * Maximum number of members with details on a page, or zero for no
+   * maximum.
+   */
+  std::size_t split_members;
+
+  /**
+   * Maximum estimated size of the details of members on a page, in bytes, or
+   * zero for no maximum.
+   */
+  std::size_t split_bytes;
+
+  /**
+   * Tar archive to which to write pages, if any.
+   */
+  std::unique_ptr<TarWriter> tar;
+
+  /**
+   * Page templates, by kind of page (see layout()).
+   */
+  std::vector<PageTemplate> templates;
+
+  /**
+   * Symbol table for resolving cross-references.
+   */
+  SymbolTable symbols;
+
+  /**
+   * Index of line coverage, used when coverage is enabled.
+   */
+  CoverageIndex counts;
+
+  /**
+   * Render plans, by entity.
+   */
+  std::unordered_map<const Entity*,Plan> plans;
+
+  /**
+   * Search index.
+   */
+  SearchIndex search_index;
+
+  /**
+   * Shards of the search index for the current call to generate(), as JSON,
+   * by key.
+   */
+  std::map<std::string,std::string> shards;
+
+  /**
+   * Shared coverage data for the current call to generate(), as JSON.
+   */
+  std::string json;
+
+  /**
+   * Pages enqueued during the current call to generate().
+   */
+  std::vector<Page> queue;
+
+  /**
+   * Manifest of files generated by the previous build.
+   */
+  Manifest previous;
+
+  /**
+   * Manifest of files generated by calls to generate().
+   */
+  Manifest current;
+
+  /**
+   * Map of the source files that contribute to each subtree, loaded from
+   * the previous build, then rebuilt by generate().
+   */
+  ContributorMap contributors;
+
+  /**
+   * Was the manifest of the previous build found?
+   */
+  bool has_previous;
+
+  /**
+   * Number of pages written by calls to generate().
    */
-  std::unordered_set<std::filesystem::path> files;
+  int nchanged;
 };
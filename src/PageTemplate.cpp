@@ -0,0 +1,241 @@
+#include "PageTemplate.hpp"
+
+#include "Log.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * Built-in template for the pages of the root, groups and namespaces.
+ *
+ * @ingroup developer
+ */
+static const char* template_index = R""""(# {{title}}
+
+{{docs}}
+{{groups}}
+{{namespaces}}
+{{coverage}}
+{{types}}
+{{typedefs}}
+{{concepts}}
+{{macros}}
+{{variables}}
+{{operators}}
+{{functions}}
+{{enumerators}}
+{{details}}
+)"""";
+
+/**
+ * Built-in template for the pages of types.
+ *
+ * @ingroup developer
+ */
+static const char* template_type = R""""(# {{title}}
+
+**{{decl}}**
+
+{{docs}}
+{{groups}}
+{{namespaces}}
+{{types}}
+{{typedefs}}
+{{concepts}}
+{{macros}}
+{{variables}}
+{{operators}}
+{{functions}}
+{{enumerators}}
+{{details}}
+)"""";
+
+/**
+ * Built-in template for the further pages of a page that is split.
+ *
+ * @ingroup developer
+ */
+static const char* template_part = R""""(# {{title}}: {{part}}
+
+{{parts}}
+{{details}}
+)"""";
+
+/**
+ * Built-in template for the root page of the code coverage report.
+ *
+ * @ingroup developer
+ */
+static const char* template_coverage_root = R""""(# Code Coverage
+
+{{sunburst}}
+{{table}}
+)"""";
+
+/**
+ * Built-in template for the directory pages of the code coverage report.
+ *
+ * @ingroup developer
+ */
+static const char* template_coverage_dir = R""""(# {{title}}
+
+{{docs}}
+{{sunburst}}
+{{table}}
+)"""";
+
+/**
+ * Built-in template for the file pages of the code coverage report.
+ *
+ * @ingroup developer
+ */
+static const char* template_coverage_file = R""""(# {{title}}
+
+{{docs}}
+{{lines}}
+{{listing}}
+)"""";
+
+/**
+ * Built-in templates, by kind of page.
+ *
+ * @ingroup developer
+ */
+static const std::pair<const char*,const char*> builtin_templates[] = {
+  {"root", template_index},
+  {"group", template_index},
+  {"namespace", template_index},
+  {"type", template_type},
+  {"part", template_part},
+  {"coverage-root", template_coverage_root},
+  {"coverage-dir", template_coverage_dir},
+  {"coverage-file", template_coverage_file}
+};
+
+/**
+ * Fields, by name, and whether each is a block.
+ *
+ * @ingroup developer
+ */
+static const struct {
+  const char* name;
+  PageTemplate::Field field;
+  bool block;
+} template_fields[] = {
+  {"title", PageTemplate::Field::TITLE, false},
+  {"name", PageTemplate::Field::NAME, false},
+  {"decl", PageTemplate::Field::DECL, false},
+  {"brief", PageTemplate::Field::BRIEF, false},
+  {"part", PageTemplate::Field::PART, false},
+  {"docs", PageTemplate::Field::DOCS, true},
+  {"groups", PageTemplate::Field::GROUPS, true},
+  {"namespaces", PageTemplate::Field::NAMESPACES, true},
+  {"coverage", PageTemplate::Field::COVERAGE, true},
+  {"types", PageTemplate::Field::TYPES, true},
+  {"typedefs", PageTemplate::Field::TYPEDEFS, true},
+  {"concepts", PageTemplate::Field::CONCEPTS, true},
+  {"macros", PageTemplate::Field::MACROS, true},
+  {"variables", PageTemplate::Field::VARIABLES, true},
+  {"operators", PageTemplate::Field::OPERATORS, true},
+  {"functions", PageTemplate::Field::FUNCTIONS, true},
+  {"enumerators", PageTemplate::Field::ENUMERATORS, true},
+  {"details", PageTemplate::Field::DETAILS, true},
+  {"parts", PageTemplate::Field::PARTS, true},
+  {"sunburst", PageTemplate::Field::SUNBURST, true},
+  {"table", PageTemplate::Field::TABLE, true},
+  {"lines", PageTemplate::Field::LINES, true},
+  {"listing", PageTemplate::Field::LISTING, true}
+};
+
+/**
+ * Get the built-in template of a kind of page.
+ *
+ * @ingroup developer
+ */
+static const char* builtin(const std::string_view& kind) {
+  for (auto& [key, value] : builtin_templates) {
+    if (kind == key) {
+      return value;
+    }
+  }
+  throw std::invalid_argument("unknown kind of page " + std::string(kind));
+}
+
+PageTemplate::PageTemplate(const std::string_view& kind) {
+  compile(builtin(kind), std::string(kind));
+}
+
+PageTemplate::PageTemplate(const std::string_view& kind,
+    const std::filesystem::path& dir) {
+  std::filesystem::path file = dir / (std::string(kind) + ".md");
+  if (dir.empty() || !std::filesystem::exists(file)) {
+    compile(builtin(kind), std::string(kind));
+  } else {
+    std::ifstream in(file, std::ios::binary);
+    std::stringstream buf;
+    buf << in.rdbuf();
+    if (!in) {
+      throw std::runtime_error("could not read " + file.string());
+    }
+    compile(buf.str(), file.string());
+  }
+}
+
+void PageTemplate::compile(const std::string_view& source,
+    const std::string& file) {
+  auto is_blank = [](const std::string_view& str) {
+    return str.find_first_not_of(" \t\r") == std::string_view::npos;
+  };
+
+  std::string text;  // literal text not yet emitted
+  std::size_t from = 0;
+  while (from < source.size()) {
+    std::size_t open = source.find("{{", from);
+    std::size_t close = open == std::string_view::npos ?
+        std::string_view::npos : source.find("}}", open + 2);
+    if (close == std::string_view::npos) {
+      text.append(source.substr(from));
+      break;
+    }
+
+    /* field name, ignoring surrounding whitespace */
+    std::string_view name = source.substr(open + 2, close - open - 2);
+    name.remove_prefix(std::min(name.find_first_not_of(" \t"), name.size()));
+    name.remove_suffix(name.size() - std::min(name.find_last_not_of(" \t") + 1,
+        name.size()));
+
+    auto found = std::find_if(std::begin(template_fields),
+        std::end(template_fields), [&](auto& f) { return name == f.name; });
+    if (found == std::end(template_fields)) {
+      warn("unknown field '" << name << "' in template " << file <<
+          ", left as is.");
+      text.append(source.substr(from, close + 2 - from));
+      from = close + 2;
+      continue;
+    }
+
+    text.append(source.substr(from, open - from));
+    from = close + 2;
+    if (found->block) {
+      /* a block alone on its line replaces the line */
+      std::size_t bol = source.rfind('\n', open);
+      bol = (bol == std::string_view::npos) ? 0 : bol + 1;
+      std::size_t eol = std::min(source.find('\n', from), source.size());
+      if (is_blank(source.substr(bol, open - bol)) &&
+          is_blank(source.substr(from, eol - from))) {
+        text.resize(text.size() - (open - bol));
+        from = std::min(eol + 1, source.size());
+      }
+    }
+    if (!text.empty()) {
+      program.push_back({Field::TEXT, std::move(text)});
+      text.clear();
+    }
+    program.push_back({found->field, std::string()});
+  }
+  if (!text.empty()) {
+    program.push_back({Field::TEXT, std::move(text)});
+  }
+}
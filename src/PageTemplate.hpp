@@ -0,0 +1,115 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Template for the layout of a page, compiled to a list of instructions.
+ *
+ * @ingroup developer
+ *
+ * A template is Markdown with fields in double braces, e.g. `{{title}}`,
+ * that are replaced with content when a page is rendered. It is compiled
+ * once, on loading, into a list of instructions, each either literal text or
+ * a field, so that rendering a page is a single pass over the list, with no
+ * further parsing.
+ *
+ * Fields are either inline, e.g. `{{title}}`, replaced with a single line of
+ * text, or blocks, e.g. `{{functions}}`, replaced with whole paragraphs,
+ * tables or lists, each followed by a blank line, or with nothing if there
+ * is no such content. A block field that stands alone on a line replaces
+ * the whole line, so that nothing is left behind where it is empty.
+ */
+class PageTemplate {
+public:
+  /**
+   * Fields.
+   */
+  enum class Field {
+    /* literal text */
+    TEXT,
+
+    /* inline fields */
+    TITLE,
+    NAME,
+    DECL,
+    BRIEF,
+    PART,
+
+    /* block fields */
+    DOCS,
+    GROUPS,
+    NAMESPACES,
+    COVERAGE,
+    TYPES,
+    TYPEDEFS,
+    CONCEPTS,
+    MACROS,
+    VARIABLES,
+    OPERATORS,
+    FUNCTIONS,
+    ENUMERATORS,
+    DETAILS,
+    PARTS,
+    SUNBURST,
+    TABLE,
+    LINES,
+    LISTING
+  };
+
+  /**
+   * Instruction.
+   */
+  struct Instruction {
+    /**
+     * Field to output.
+     */
+    Field field;
+
+    /**
+     * Text to output, for Field::TEXT.
+     */
+    std::string text;
+  };
+
+  /**
+   * Constructor. Compiles the built-in template of a kind of page.
+   *
+   * @param kind Kind of page: `root`, `group`, `namespace`, `type`, `part`,
+   * `coverage-root`, `coverage-dir` or `coverage-file`.
+   */
+  PageTemplate(const std::string_view& kind);
+
+  /**
+   * Constructor. Compiles the template of a kind of page from a directory
+   * of templates, if the directory has one, otherwise the built-in template.
+   *
+   * @param kind Kind of page.
+   * @param dir Directory of templates, holding a file `<kind>.md` for each
+   * kind of page that is customized.
+   */
+  PageTemplate(const std::string_view& kind, const std::filesystem::path& dir);
+
+  /**
+   * Instructions.
+   */
+  const std::vector<Instruction>& instructions() const {
+    return program;
+  }
+
+private:
+  /**
+   * Compile a template.
+   *
+   * @param source Source of the template.
+   * @param file File name of the template, for warnings.
+   */
+  void compile(const std::string_view& source, const std::string& file);
+
+  /**
+   * Instructions.
+   */
+  std::vector<Instruction> program;
+};
@@ -0,0 +1,84 @@
+#include "SearchIndex.hpp"
+
+#include "BufferedWriter.hpp"
+#include "JSONExporter.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+
+void SearchIndex::insert(const std::string_view& name,
+    const std::string_view& qualified, const std::string_view& kind,
+    const std::string_view& url, const std::string_view& brief) {
+  entries[key(name)].push_back(Entry{std::string(name),
+      std::string(qualified), std::string(kind), std::string(url),
+      std::string(brief)});
+}
+
+void SearchIndex::clear() {
+  entries.clear();
+}
+
+std::map<std::string,std::string> SearchIndex::shards() const {
+  std::map<std::string,std::string> result;
+  for (auto& [k, list] : entries) {
+    std::vector<const Entry*> sorted;
+    sorted.reserve(list.size());
+    for (auto& entry : list) {
+      sorted.push_back(&entry);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const Entry* a, const Entry* b) {
+          return std::tie(a->name, a->qualified, a->url) <
+              std::tie(b->name, b->qualified, b->url);
+        });
+
+    std::ostringstream buf;
+    {
+      BufferedWriter w(buf);
+      w.put('[');
+      const Entry* prev = nullptr;
+      for (auto entry : sorted) {
+        /* entries that differ only in brief description, e.g. overloads,
+         * share a link, so keep just the first */
+        if (prev && prev->qualified == entry->qualified &&
+            prev->url == entry->url) {
+          continue;
+        }
+        if (prev) {
+          w.put(',');
+        }
+        w.put('[');
+        JSONExporter::string(entry->name, w);
+        w.put(',');
+        JSONExporter::string(entry->qualified, w);
+        w.put(',');
+        JSONExporter::string(entry->kind, w);
+        w.put(',');
+        JSONExporter::string(entry->url, w);
+        w.put(',');
+        JSONExporter::string(entry->brief, w);
+        w.put(']');
+        prev = entry;
+      }
+      w.write("]\n");
+    }
+    result.emplace(k, buf.str());
+  }
+  return result;
+}
+
+std::string SearchIndex::key(const std::string_view& name) {
+  std::string k;
+  for (std::size_t i = 0; i < name.size() && i < 2; ++i) {
+    char c = name[i];
+    if ('A' <= c && c <= 'Z') {
+      k += char(c - 'A' + 'a');
+    } else if (('a' <= c && c <= 'z') || ('0' <= c && c <= '9')) {
+      k += c;
+    } else {
+      k += '_';
+    }
+  }
+  return k.empty() ? "_" : k;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Search index of documented entities, sharded by prefix.
+ *
+ * @ingroup developer
+ *
+ * Entries are grouped into shards by the first two characters of their
+ * names, lowercased, so that a client need only fetch the one small shard
+ * for what has been typed so far, rather than an index of the whole site.
+ * Each shard is a JSON array of entries, each itself an array of the name,
+ * qualified name, kind, URL relative to the output directory, and brief
+ * description.
+ */
+class SearchIndex {
+public:
+  /**
+   * Insert an entry. An entry with the same qualified name and URL as
+   * another, e.g. an overloaded function, is inserted only once.
+   *
+   * @param name Name.
+   * @param qualified Qualified name.
+   * @param kind Kind of entity, e.g. "function".
+   * @param url URL of its documentation, relative to the output directory.
+   * @param brief Brief description.
+   */
+  void insert(const std::string_view& name, const std::string_view& qualified,
+      const std::string_view& kind, const std::string_view& url,
+      const std::string_view& brief);
+
+  /**
+   * Clear the index.
+   */
+  void clear();
+
+  /**
+   * Shards, as JSON, by key. Entries within each shard are sorted, so that
+   * identical indices produce identical shards.
+   */
+  std::map<std::string,std::string> shards() const;
+
+  /**
+   * Shard key for a name: its first two characters, lowercased, with any
+   * other than letters, digits and underscores replaced by underscores.
+   */
+  static std::string key(const std::string_view& name);
+
+private:
+  /**
+   * Entry.
+   */
+  struct Entry {
+    std::string name;
+    std::string qualified;
+    std::string kind;
+    std::string url;
+    std::string brief;
+  };
+
+  /**
+   * Entries, by shard key.
+   */
+  std::map<std::string,std::vector<Entry>> entries;
+};
@@ -0,0 +1,791 @@
+#include "Snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#define HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Snapshot format version. This must be incremented on any change to the
+ * format; snapshots of other versions are rejected on reading.
+ *
+ * @ingroup developer
+ */
+static const uint32_t SNAPSHOT_VERSION = 6;
+
+/**
+ * Magic bytes at the start of a snapshot file.
+ *
+ * @ingroup developer
+ */
+static const char SNAPSHOT_MAGIC[8] = {'D', 'O', 'X', 'I', 'D', 'E', 'S', 'N'};
+
+/**
+ * Byte order mark. Read with the wrong byte order, this has a different
+ * value.
+ *
+ * @ingroup developer
+ */
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/**
+ * Value of SnapshotEntity::decl indicating that the declaration is a slice
+ * of the source of the file.
+ *
+ * @ingroup developer
+ */
+static const uint32_t SNAPSHOT_SLICE = UINT32_MAX;
+
+/**
+ * Snapshot file header. Sections are given as a number of elements and an
+ * offset in bytes from the start of the file.
+ *
+ * @ingroup developer
+ */
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t byte_order;
+  uint32_t version;
+
+  /**
+   * Coverage file and output directory, as string indices.
+   */
+  uint32_t coverage, output;
+
+  /**
+   * Build options: search and templates directory, as string indices, limits
+   * on the size of pages, and whether highlighting was enabled.
+   */
+  uint32_t search, templates;
+  uint64_t split_members, split_bytes;
+  uint32_t highlight, unused;
+
+  /**
+   * String table: `nstrings + 1` offsets into the characters, followed by
+   * the characters.
+   */
+  uint64_t nstrings, strings;
+  uint64_t nchars, chars;
+
+  /**
+   * Entities, in preorder.
+   */
+  uint64_t nentities, entities;
+
+  /**
+   * Line bitmaps of all files, concatenated; for each file, the bitmap of
+   * included lines followed by that of covered lines.
+   */
+  uint64_t nwords, words;
+
+  /**
+   * Counts of covered lines of all files, concatenated.
+   */
+  uint64_t ncounts, counts;
+
+  /**
+   * Sources of files.
+   */
+  uint64_t nsources, sources;
+
+  /**
+   * Contributions of files to the model.
+   */
+  uint64_t ncontributions, contributions;
+
+  /**
+   * Declarations of namespaces declared in more than one file.
+   */
+  uint64_t ndeclarations, declarations;
+};
+
+/**
+ * Entity record in a snapshot. Strings are given as indices into the string
+ * table. The children of an entity follow it immediately, in preorder, and
+ * in the order of Entity::lists.
+ *
+ * @ingroup developer
+ */
+struct SnapshotEntity {
+  /**
+   * Line counts, as the number of lines `nlines`, a range `[words, words +
+   * 2*LineCounts::words(nlines))` into the line bitmaps section, and a range
+   * `[counts, counts + ncounts)` into the counts section.
+   */
+  uint64_t words, counts;
+  uint32_t nlines, ncounts;
+
+  uint32_t name, docs, title, brief, path, scope;
+
+  /**
+   * Declaration, as a string index, or `SNAPSHOT_SLICE` if a slice
+   * `[decl_begin, decl_begin + decl_size)` of the source of the file. If a
+   * string index, `decl_styles` is the string index of its syntax
+   * highlighting, if any; a slice takes its highlighting from the source.
+   */
+  uint32_t decl, decl_begin, decl_size, decl_styles;
+
+  uint32_t start_line, end_line;
+  int32_t lines_included, lines_covered, ndecls;
+  uint32_t nchildren;
+
+  uint8_t type, visible, hide, unused;
+};
+
+/**
+ * Count of a covered line in a snapshot.
+ *
+ * @ingroup developer
+ */
+struct SnapshotCount {
+  uint32_t line, unused;
+  uint64_t count;
+};
+
+/**
+ * Source record in a snapshot.
+ *
+ * @ingroup developer
+ */
+struct SnapshotSource {
+  /**
+   * Path, source, and syntax highlighting of the source, if any, as string
+   * indices.
+   */
+  uint32_t path, source, styles, unused;
+};
+
+/**
+ * Contribution record in a snapshot. Records for each file are in the order
+ * that the contributions were made.
+ *
+ * @ingroup developer
+ */
+struct SnapshotContribution {
+  uint32_t path, entity;
+};
+
+/**
+ * Declaration record in a snapshot, for Entity::declarations. Records for
+ * each namespace are in order. The declaration is stored as for
+ * SnapshotEntity.
+ *
+ * @ingroup developer
+ */
+struct SnapshotDeclaration {
+  uint32_t entity, path;
+  uint32_t decl, decl_begin, decl_size, decl_styles;
+  uint32_t start_line, end_line;
+  uint32_t docs_size, brief_size;
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+static_assert(std::is_trivially_copyable_v<SnapshotEntity>);
+static_assert(std::is_trivially_copyable_v<SnapshotDeclaration>);
+static_assert(sizeof(SnapshotEntity) == 96);
+
+/**
+ * Round up to a multiple of eight bytes, so that all sections are aligned.
+ *
+ * @ingroup developer
+ */
+static uint64_t align8(const uint64_t n) {
+  return (n + 7) & ~uint64_t(7);
+}
+
+/**
+ * Hash of strings that accepts views as well, so that the index of the
+ * string table can be searched without constructing a string.
+ *
+ * @ingroup developer
+ */
+struct SnapshotHash {
+  using is_transparent = void;
+
+  std::size_t operator()(const std::string_view& str) const {
+    return std::hash<std::string_view>()(str);
+  }
+};
+
+/**
+ * Snapshot writer state.
+ *
+ * @ingroup developer
+ */
+struct SnapshotWriter {
+  SnapshotWriter() :
+      offsets{0} {
+    /* the empty string is always index zero */
+    add(std::string_view());
+  }
+
+  /**
+   * Add a string to the string table.
+   *
+   * @param str String.
+   * @param unique Is the string unlikely to be repeated? If so it is not
+   * looked up in, nor added to, the index of existing strings.
+   *
+   * @return Index of the string.
+   */
+  uint32_t add(const std::string_view& str, const bool unique = false) {
+    if (!unique) {
+      auto iter = ids.find(str);
+      if (iter != ids.end()) {
+        return iter->second;
+      }
+    }
+    uint32_t id = uint32_t(offsets.size() - 1);
+    chars.append(str);
+    offsets.push_back(chars.size());
+    if (!unique) {
+      ids.emplace(str, id);
+    }
+    return id;
+  }
+
+  /**
+   * Add a file path to the string table, and to the files seen.
+   *
+   * @return Index of the path.
+   */
+  uint32_t add(const FilePath& path) {
+    if (!path.empty() && seen.insert(path).second) {
+      paths.push_back(path);
+    }
+    return add(path.string());
+  }
+
+  /**
+   * Add a declaration, as a slice of the source of its file where possible,
+   * otherwise to the string table.
+   *
+   * @param path Path of the file.
+   * @param decl Declaration.
+   * @param[out] index String index, or `SNAPSHOT_SLICE` for a slice.
+   * @param[out] begin Start of the slice.
+   * @param[out] size Size of the slice.
+   * @param[out] styles String index of any syntax highlighting, if not a
+   * slice.
+   */
+  void add(const FilePath& path, const std::string_view& decl,
+      uint32_t& index, uint32_t& begin, uint32_t& size, uint32_t& styles) {
+    auto source = path.source();
+    std::less_equal<const char*> le;
+    if (!decl.empty() && le(source.data(), decl.data()) &&
+        le(decl.data() + decl.size(), source.data() + source.size())) {
+      index = SNAPSHOT_SLICE;
+      begin = uint32_t(decl.data() - source.data());
+      size = uint32_t(decl.size());
+    } else {
+      index = add(decl);
+      auto s = path.styles(decl);
+      styles = s.empty() ? 0 : add(s, true);
+    }
+  }
+
+  /**
+   * Add an entity and, recursively, its children.
+   */
+  void add(const Entity& e) {
+    uint32_t i = uint32_t(entities.size());
+    index.emplace(&e, i);
+
+    SnapshotEntity r{};
+    r.name = add(e.name.view());
+    r.docs = add(e.docs);
+    r.title = add(e.title);
+    r.brief = add(e.brief);
+    r.scope = add(e.scope);
+    r.path = add(e.path);
+    add(e.path, e.decl, r.decl, r.decl_begin, r.decl_size, r.decl_styles);
+    r.start_line = e.start_line;
+    r.end_line = e.end_line;
+    r.lines_included = e.lines_included;
+    r.lines_covered = e.lines_covered;
+    r.ndecls = e.ndecls;
+    auto& lines = e.line_counts;
+    r.nlines = lines.size();
+    r.words = words.size();
+    words.insert(words.end(), lines.included_bits().begin(),
+        lines.included_bits().end());
+    words.insert(words.end(), lines.covered_bits().begin(),
+        lines.covered_bits().end());
+    r.counts = counts.size();
+    r.ncounts = uint32_t(lines.counts().size());
+    for (auto& c : lines.counts()) {
+      counts.push_back({c.line, 0, c.count});
+    }
+    r.type = uint8_t(e.type);
+    r.visible = e.visible;
+    r.hide = e.hide;
+    for (auto list : Entity::lists) {
+      r.nchildren += uint32_t((e.*list).size());
+    }
+    entities.push_back(r);
+
+    for (auto& d : e.declarations) {
+      SnapshotDeclaration s{};
+      s.entity = i;
+      s.path = add(d.path);
+      add(d.path, d.decl, s.decl, s.decl_begin, s.decl_size, s.decl_styles);
+      s.start_line = d.start_line;
+      s.end_line = d.end_line;
+      s.docs_size = uint32_t(d.docs_size);
+      s.brief_size = uint32_t(d.brief_size);
+      declarations.push_back(s);
+    }
+
+    for (auto list : Entity::lists) {
+      for (auto& child : e.*list) {
+        add(child);
+      }
+    }
+  }
+
+  /**
+   * Add the sources and contributions of all files seen.
+   */
+  void finish() {
+    for (auto& path : paths) {
+      uint32_t id = add(path.string());
+      auto styles = path.styles(path.source());
+      sources.push_back({id, add(path.source(), true),
+          styles.empty() ? 0 : add(styles, true), 0});
+      for (auto& iter : path.contributions()) {
+        auto found = index.find(&*iter);
+        if (found != index.end()) {
+          contributions.push_back({id, found->second});
+        }
+      }
+    }
+  }
+
+  std::vector<uint64_t> offsets;
+  std::string chars;
+  std::unordered_map<std::string,uint32_t,SnapshotHash,std::equal_to<>> ids;
+  std::vector<SnapshotEntity> entities;
+  std::vector<uint64_t> words;
+  std::vector<SnapshotCount> counts;
+  std::vector<SnapshotSource> sources;
+  std::vector<SnapshotContribution> contributions;
+  std::vector<SnapshotDeclaration> declarations;
+
+  /**
+   * Indices of entities, by address.
+   */
+  std::unordered_map<const Entity*,uint32_t> index;
+
+  /**
+   * Files seen, in order of first appearance.
+   */
+  std::vector<FilePath> paths;
+  std::unordered_set<FilePath> seen;
+};
+
+/**
+ * Contents of a snapshot file, mapped into memory where the platform
+ * supports it, otherwise read into a buffer.
+ *
+ * @ingroup developer
+ */
+struct SnapshotFile {
+  SnapshotFile(const std::filesystem::path& file) {
+#ifdef HAVE_MMAP
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      struct stat st;
+      if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd,
+            0);
+        if (addr != MAP_FAILED) {
+          mapped = static_cast<const char*>(addr);
+          size = st.st_size;
+        }
+      }
+      ::close(fd);
+    }
+    if (mapped) {
+      return;
+    }
+#endif
+
+    /* fall back to reading the whole file at once */
+    std::ifstream in(file, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+      throw std::runtime_error("could not read file " + file.string());
+    }
+    buffer.resize(in.tellg());
+    in.seekg(0);
+    if (!in.read(buffer.data(), buffer.size())) {
+      throw std::runtime_error("could not read file " + file.string());
+    }
+  }
+
+  SnapshotFile(const SnapshotFile&) = delete;
+  SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+  ~SnapshotFile() {
+#ifdef HAVE_MMAP
+    if (mapped) {
+      ::munmap(const_cast<char*>(mapped), size);
+    }
+#endif
+  }
+
+  /**
+   * Contents of the file.
+   */
+  std::string_view view() const {
+    return mapped ? std::string_view(mapped, size) :
+        std::string_view(buffer.data(), buffer.size());
+  }
+
+  /**
+   * Mapped contents, or `nullptr` if read instead.
+   */
+  const char* mapped = nullptr;
+
+  /**
+   * Size of the mapped contents.
+   */
+  std::size_t size = 0;
+
+  /**
+   * Contents, if read instead.
+   */
+  std::vector<char> buffer;
+};
+
+/**
+ * Snapshot reader state. All sections are validated against the size of the
+ * buffer before use, so that a truncated or corrupt snapshot produces an
+ * error rather than undefined behavior.
+ *
+ * @ingroup developer
+ */
+struct SnapshotReader {
+  SnapshotReader(const std::string_view& buffer) :
+      buffer(buffer) {
+    if (buffer.size() < sizeof(SnapshotHeader)) {
+      corrupt();
+    }
+    header = reinterpret_cast<const SnapshotHeader*>(buffer.data());
+    if (!std::equal(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC),
+        header->magic)) {
+      throw std::runtime_error("not a Doxide snapshot");
+    }
+    if (header->byte_order != SNAPSHOT_BYTE_ORDER) {
+      throw std::runtime_error("snapshot was written on a platform of "
+          "different byte order");
+    }
+    if (header->version != SNAPSHOT_VERSION) {
+      throw std::runtime_error("snapshot is of version " +
+          std::to_string(header->version) + " but version " +
+          std::to_string(SNAPSHOT_VERSION) + " is required; rebuild it");
+    }
+    offsets = section<uint64_t>(header->nstrings + 1, header->strings);
+    chars = section<char>(header->nchars, header->chars);
+    entities = section<SnapshotEntity>(header->nentities, header->entities);
+    words = section<uint64_t>(header->nwords, header->words);
+    counts = section<SnapshotCount>(header->ncounts, header->counts);
+    sources = section<SnapshotSource>(header->nsources, header->sources);
+    contributions = section<SnapshotContribution>(header->ncontributions,
+        header->contributions);
+    declarations = section<SnapshotDeclaration>(header->ndeclarations,
+        header->declarations);
+  }
+
+  /**
+   * Get a section, checking that it lies within the buffer.
+   */
+  template<class T>
+  const T* section(const uint64_t n, const uint64_t offset) const {
+    if (offset > buffer.size() || offset % alignof(T) != 0 ||
+        n > (buffer.size() - offset)/sizeof(T)) {
+      corrupt();
+    }
+    return reinterpret_cast<const T*>(buffer.data() + offset);
+  }
+
+  /**
+   * Get a string.
+   */
+  std::string_view str(const uint32_t i) const {
+    if (i >= header->nstrings || offsets[i] > offsets[i + 1] ||
+        offsets[i + 1] > header->nchars) {
+      corrupt();
+    }
+    return std::string_view(chars + offsets[i], offsets[i + 1] - offsets[i]);
+  }
+
+  /**
+   * Get a file path.
+   */
+  FilePath path(const uint32_t i) {
+    auto iter = paths.find(i);
+    if (iter == paths.end()) {
+      iter = paths.emplace(i, FilePath(str(i))).first;
+    }
+    return iter->second;
+  }
+
+  /**
+   * Get a declaration, as stored by SnapshotWriter::add().
+   */
+  std::string_view decl(FilePath path, const uint32_t index,
+      const uint32_t begin, const uint32_t size, const uint32_t styles) {
+    if (index == SNAPSHOT_SLICE) {
+      auto source = path.source();
+      if (begin > source.size() || size > source.size() - begin) {
+        corrupt();
+      }
+      return source.substr(begin, size);
+    } else if (index != 0) {
+      return path.own(std::string(str(index)), std::string(str(styles)));
+    } else {
+      return std::string_view();
+    }
+  }
+
+  /**
+   * Read an entity and, recursively, its children.
+   *
+   * @param e Entity to read into.
+   * @param i Index of the entity. On return, the index of the entity after
+   * it and its children.
+   */
+  void read(Entity& e, uint32_t& i) {
+    if (i >= header->nentities) {
+      corrupt();
+    }
+    const SnapshotEntity& r = entities[i++];
+
+    e.name = str(r.name);
+    e.docs = str(r.docs);
+    e.title = str(r.title);
+    e.brief = str(r.brief);
+    e.scope = str(r.scope);
+    e.path = path(r.path);
+    e.decl = decl(e.path, r.decl, r.decl_begin, r.decl_size, r.decl_styles);
+    e.start_line = r.start_line;
+    e.end_line = r.end_line;
+    e.lines_included = r.lines_included;
+    e.lines_covered = r.lines_covered;
+    e.ndecls = r.ndecls;
+    uint64_t nwords = LineCounts::words(r.nlines);
+    if (r.words > header->nwords || 2*nwords > header->nwords - r.words ||
+        r.counts > header->ncounts || r.ncounts > header->ncounts - r.counts) {
+      corrupt();
+    }
+    std::vector<LineCounts::Count> line_counts;
+    line_counts.reserve(r.ncounts);
+    for (uint32_t k = 0; k < r.ncounts; ++k) {
+      auto& c = counts[r.counts + k];
+      line_counts.push_back({c.line, c.count});
+    }
+    e.line_counts.assign(r.nlines, words + r.words, words + r.words + nwords,
+        line_counts.data(), line_counts.data() + line_counts.size());
+    e.type = EntityType(r.type);
+    e.visible = r.visible;
+    e.hide = r.hide;
+
+    for (uint32_t k = 0; k < r.nchildren; ++k) {
+      if (i >= header->nentities) {
+        corrupt();
+      }
+      auto type = EntityType(entities[i].type);
+      if (type < EntityType::NAMESPACE || type > EntityType::FILE ||
+          type == EntityType::TEMPLATE) {
+        corrupt();
+      }
+      auto& list = e.children(type);
+      auto& child = list.emplace_back();
+      child.parent = &e;
+      iters[i] = std::prev(list.end());
+      read(child, i);
+    }
+  }
+
+  [[noreturn]] static void corrupt() {
+    throw std::runtime_error("snapshot is truncated or corrupt");
+  }
+
+  std::string_view buffer;
+  const SnapshotHeader* header;
+  const uint64_t* offsets;
+  const char* chars;
+  const SnapshotEntity* entities;
+  const uint64_t* words;
+  const SnapshotCount* counts;
+  const SnapshotSource* sources;
+  const SnapshotContribution* contributions;
+  const SnapshotDeclaration* declarations;
+
+  /**
+   * Iterators to entities, by index.
+   */
+  std::vector<FilePath::entity_iterator> iters;
+
+  /**
+   * File paths, by string index.
+   */
+  std::unordered_map<uint32_t,FilePath> paths;
+};
+
+Snapshot::Snapshot() :
+    split_members(0),
+    split_bytes(0),
+    highlight(false) {
+  //
+}
+
+void Snapshot::write(const std::filesystem::path& file, const Entity& root) {
+  SnapshotWriter w;
+  w.add(root);
+  w.finish();
+
+  SnapshotHeader header{};
+  std::copy(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC),
+      header.magic);
+  header.byte_order = SNAPSHOT_BYTE_ORDER;
+  header.version = SNAPSHOT_VERSION;
+  header.coverage = w.add(coverage.string());
+  header.output = w.add(output.string());
+  header.search = w.add(search);
+  header.templates = w.add(templates.string());
+  header.split_members = split_members;
+  header.split_bytes = split_bytes;
+  header.highlight = highlight;
+
+  /* lay out sections */
+  uint64_t pos = align8(sizeof(SnapshotHeader));
+  auto layout = [&](const uint64_t n, const uint64_t size) {
+    uint64_t offset = pos;
+    pos = align8(pos + n*size);
+    return offset;
+  };
+  header.nstrings = w.offsets.size() - 1;
+  header.strings = layout(w.offsets.size(), sizeof(uint64_t));
+  header.nchars = w.chars.size();
+  header.chars = layout(w.chars.size(), sizeof(char));
+  header.nentities = w.entities.size();
+  header.entities = layout(w.entities.size(), sizeof(SnapshotEntity));
+  header.nwords = w.words.size();
+  header.words = layout(w.words.size(), sizeof(uint64_t));
+  header.ncounts = w.counts.size();
+  header.counts = layout(w.counts.size(), sizeof(SnapshotCount));
+  header.nsources = w.sources.size();
+  header.sources = layout(w.sources.size(), sizeof(SnapshotSource));
+  header.ncontributions = w.contributions.size();
+  header.contributions = layout(w.contributions.size(),
+      sizeof(SnapshotContribution));
+  header.ndeclarations = w.declarations.size();
+  header.declarations = layout(w.declarations.size(),
+      sizeof(SnapshotDeclaration));
+
+  if (file.has_parent_path()) {
+    std::filesystem::create_directories(file.parent_path());
+  }
+  std::ofstream out(file, std::ios::out | std::ios::binary);
+  if (!out.is_open()) {
+    throw std::runtime_error("could not write file " + file.string());
+  }
+  static const char zeros[8] = {};
+  auto put = [&](const void* data, const uint64_t bytes) {
+    out.write(static_cast<const char*>(data), bytes);
+    out.write(zeros, align8(bytes) - bytes);
+  };
+  put(&header, sizeof(header));
+  put(w.offsets.data(), w.offsets.size()*sizeof(uint64_t));
+  put(w.chars.data(), w.chars.size());
+  put(w.entities.data(), w.entities.size()*sizeof(SnapshotEntity));
+  put(w.words.data(), w.words.size()*sizeof(uint64_t));
+  put(w.counts.data(), w.counts.size()*sizeof(SnapshotCount));
+  put(w.sources.data(), w.sources.size()*sizeof(SnapshotSource));
+  put(w.contributions.data(),
+      w.contributions.size()*sizeof(SnapshotContribution));
+  put(w.declarations.data(),
+      w.declarations.size()*sizeof(SnapshotDeclaration));
+  if (!out) {
+    throw std::runtime_error("could not write file " + file.string());
+  }
+}
+
+void Snapshot::read(const std::filesystem::path& file, Entity& root) {
+  /* the format is designed to be used in place, without further parsing */
+  SnapshotFile buffer(file);
+  SnapshotReader r(buffer.view());
+  coverage = r.str(r.header->coverage);
+  output = r.str(r.header->output);
+  search = r.str(r.header->search);
+  templates = r.str(r.header->templates);
+  split_members = r.header->split_members;
+  split_bytes = r.header->split_bytes;
+  highlight = r.header->highlight;
+
+  /* sources first, as declarations are views of them */
+  for (uint64_t k = 0; k < r.header->nsources; ++k) {
+    FilePath path = r.path(r.sources[k].path);
+    path.load(std::string(r.str(r.sources[k].source)));
+    path.highlight(std::string(r.str(r.sources[k].styles)));
+  }
+
+  root.clear();
+  r.iters.resize(r.header->nentities);
+  uint32_t i = 0;
+  r.read(root, i);
+  if (i != r.header->nentities) {
+    r.corrupt();
+  }
+
+  /* restore contributions, in order, for incremental updates */
+  for (uint64_t k = 0; k < r.header->ncontributions; ++k) {
+    auto& c = r.contributions[k];
+    if (c.entity == 0 || c.entity >= r.header->nentities) {
+      r.corrupt();
+    }
+    r.path(c.path).contribute(r.iters[c.entity]);
+  }
+
+  /* restore declarations of namespaces, so that a file can later be removed
+   * from a namespace that other files also declare */
+  std::size_t docs_size = 0, brief_size = 0;
+  for (uint64_t k = 0; k < r.header->ndeclarations; ++k) {
+    auto& d = r.declarations[k];
+    if (d.entity == 0 || d.entity >= r.header->nentities ||
+        r.iters[d.entity]->type != EntityType::NAMESPACE) {
+      r.corrupt();
+    }
+    Entity& e = *r.iters[d.entity];
+    if (e.declarations.empty()) {
+      docs_size = 0;
+      brief_size = 0;
+    }
+    docs_size += d.docs_size;
+    brief_size += d.brief_size;
+    if (docs_size > e.docs.size() || brief_size > e.brief.size()) {
+      r.corrupt();
+    }
+    FilePath path = r.path(d.path);
+    e.declarations.push_back(Entity::Declaration{path,
+        r.decl(path, d.decl, d.decl_begin, d.decl_size, d.decl_styles),
+        d.start_line, d.end_line, d.docs_size, d.brief_size});
+  }
+}
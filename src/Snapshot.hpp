@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Entity.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+/**
+ * Binary snapshot of the entity model.
+ *
+ * @ingroup developer
+ *
+ * A snapshot records the fully-built model---after parsing and counting
+ * line coverage---so that later commands can load it in place of reading the
+ * configuration file and parsing the sources again. It includes the source
+ * of each file and any syntax highlighting of it, line counts, and the
+ * record of entities contributed by each file, so that a model loaded from
+ * a snapshot can be updated incrementally as for one that was parsed.
+ *
+ * The format is a fixed header followed by flat sections of fixed-size
+ * records, addressed by offsets from the start of the file: a string table,
+ * the entities in preorder, line counts, sources, contributions, and the
+ * declarations of namespaces declared in more than one file. It is mapped
+ * into memory where the platform supports it, otherwise read in a single
+ * bulk read, and decoded without parsing. Entity declarations are stored as offsets into the source
+ * of their file where possible. The format is in native byte order, and
+ * carries a version number that must match exactly on reading.
+ */
+class Snapshot {
+public:
+  /**
+   * Constructor.
+   */
+  Snapshot();
+
+  /**
+   * Write a snapshot.
+   *
+   * @param file Snapshot file.
+   * @param root Root entity.
+   */
+  void write(const std::filesystem::path& file, const Entity& root);
+
+  /**
+   * Read a snapshot.
+   *
+   * @param file Snapshot file.
+   * @param root Root entity. This is cleared and replaced with the model
+   * from the snapshot.
+   */
+  void read(const std::filesystem::path& file, Entity& root);
+
+  /**
+   * Coverage file. This is recorded in the snapshot on write, and restored
+   * on read.
+   */
+  std::filesystem::path coverage;
+
+  /**
+   * Output directory. This is recorded in the snapshot on write, and
+   * restored on read.
+   */
+  std::filesystem::path output;
+
+  /**
+   * Search, as for Driver::search. This and the other build options below
+   * are recorded in the snapshot on write, and restored on read.
+   */
+  std::string search;
+
+  /**
+   * Maximum number of members with details on a page, as for
+   * Driver::split_members.
+   */
+  std::size_t split_members;
+
+  /**
+   * Maximum size of the details of members on a page, as for
+   * Driver::split_bytes.
+   */
+  std::size_t split_bytes;
+
+  /**
+   * Were declarations and sources pre-highlighted?
+   */
+  bool highlight;
+
+  /**
+   * Directory of page templates.
+   */
+  std::filesystem::path templates;
+};
@@ -18,12 +18,12 @@ SourceWatcher::SourceWatcher(std::string pattern): SourceWatcher(std::list<std::
   //
 }
 
-std::tuple<std::unordered_set<std::filesystem::path>,
-           std::unordered_set<std::filesystem::path>,
-           std::unordered_set<std::filesystem::path>> SourceWatcher::diff(){
-  std::unordered_set<std::filesystem::path> added_files;
-  std::unordered_set<std::filesystem::path> modified_files;
-  std::unordered_set<std::filesystem::path> deleted_files = filenames();
+std::tuple<std::set<std::filesystem::path>,
+           std::set<std::filesystem::path>,
+           std::set<std::filesystem::path>> SourceWatcher::diff(){
+  std::set<std::filesystem::path> added_files;
+  std::set<std::filesystem::path> modified_files;
+  std::set<std::filesystem::path> deleted_files = filenames();
 
   for (auto pattern : patterns){
     auto paths = glob::rglob(pattern);
@@ -58,8 +58,8 @@ bool SourceWatcher::changed(){
   return !added_files.empty() || !modified_files.empty() || !deleted_files.empty();
 }
 
-std::unordered_set<std::filesystem::path> SourceWatcher::filenames(){
-  std::unordered_set<std::filesystem::path> filenames;
+std::set<std::filesystem::path> SourceWatcher::filenames(){
+  std::set<std::filesystem::path> filenames;
   for (auto pairs : tracked_files) {
     filenames.insert(pairs.first);
   }
@@ -2,7 +2,7 @@
 
 #include <filesystem>
 #include <list>
-#include <unordered_set>
+#include <set>
 #include <unordered_map>
 #include <tuple>
 #include <string>
@@ -36,17 +36,17 @@ public:
   /**
    * Check if any of the watched files changed since the last call to `changed()` or `diff()`.
    *
-   * @return A tuple containing sets of added, modified and deleted file paths.
+   * @return A tuple containing sets of added, modified and deleted file
+   * paths, each ordered.
    */
-  std::tuple<std::unordered_set<std::filesystem::path>,
-             std::unordered_set<std::filesystem::path>,
-             std::unordered_set<std::filesystem::path>> diff();
+  std::tuple<std::set<std::filesystem::path>,
+             std::set<std::filesystem::path>,
+             std::set<std::filesystem::path>> diff();
 
   /**
-   * The current source files.
-   *
+   * The current source files, ordered.
    */
-  std::unordered_set<std::filesystem::path> filenames();
+  std::set<std::filesystem::path> filenames();
 
 private:
   /**
@@ -0,0 +1,75 @@
+#include "Symbol.hpp"
+
+#include <deque>
+#include <unordered_map>
+
+/**
+ * Table of interned strings.
+ *
+ * @ingroup developer
+ */
+struct SymbolStrings {
+  SymbolStrings() {
+    /* the empty string is always index zero */
+    strings.emplace_back();
+    ids.emplace(strings.back(), 0);
+  }
+
+  uint32_t intern(const std::string_view& str) {
+    auto iter = ids.find(str);
+    if (iter != ids.end()) {
+      return iter->second;
+    } else {
+      /* std::deque does not relocate elements on growth, so views into
+       * them used as keys remain valid */
+      uint32_t id = uint32_t(strings.size());
+      strings.emplace_back(str);
+      ids.emplace(strings.back(), id);
+      return id;
+    }
+  }
+
+  /**
+   * Strings, by index.
+   */
+  std::deque<std::string> strings;
+
+  /**
+   * Indices, by string.
+   */
+  std::unordered_map<std::string_view,uint32_t> ids;
+};
+
+/**
+ * Get the run-wide table of interned strings.
+ *
+ * @ingroup developer
+ */
+static SymbolStrings& table() {
+  static SymbolStrings t;
+  return t;
+}
+
+Symbol::Symbol() :
+    _id(0) {
+  //
+}
+
+Symbol::Symbol(const std::string_view& str) :
+    _id(str.empty() ? 0 : table().intern(str)) {
+  //
+}
+
+Symbol::Symbol(const std::string& str) :
+    Symbol(std::string_view(str)) {
+  //
+}
+
+Symbol::Symbol(const char* str) :
+    Symbol(std::string_view(str)) {
+  //
+}
+
+const std::string& Symbol::str() const {
+  return table().strings[_id];
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * Interned string, used for entity names.
+ *
+ * @ingroup developer
+ *
+ * Each distinct string is stored once in a run-wide table, and a Symbol
+ * holds only its index into that table. Names such as those of namespaces,
+ * common member functions and operators repeat many times across a code
+ * base; interning them saves memory and reduces equality comparisons to
+ * integer comparisons. The empty string always has index zero.
+ */
+class Symbol {
+public:
+  /**
+   * Construct the empty symbol.
+   */
+  Symbol();
+
+  /**
+   * Constructor.
+   *
+   * @param str String to intern.
+   */
+  Symbol(const std::string_view& str);
+
+  /**
+   * Constructor.
+   *
+   * @param str String to intern.
+   */
+  Symbol(const std::string& str);
+
+  /**
+   * Constructor.
+   *
+   * @param str String to intern.
+   */
+  Symbol(const char* str);
+
+  /**
+   * Get the string.
+   */
+  const std::string& str() const;
+
+  /**
+   * Get the string.
+   */
+  operator const std::string&() const {
+    return str();
+  }
+
+  /**
+   * Get the string as a view.
+   */
+  std::string_view view() const {
+    return str();
+  }
+
+  /**
+   * Index into the table.
+   */
+  uint32_t id() const {
+    return _id;
+  }
+
+  /**
+   * Is this the empty symbol?
+   */
+  bool empty() const {
+    return _id == 0;
+  }
+
+  /**
+   * Equality comparison, by index.
+   */
+  friend bool operator==(const Symbol& a, const Symbol& b) {
+    return a._id == b._id;
+  }
+
+  /**
+   * Ordering comparison, by string.
+   */
+  friend bool operator<(const Symbol& a, const Symbol& b) {
+    return a._id != b._id && a.str() < b.str();
+  }
+
+private:
+  /**
+   * Index into the table.
+   */
+  uint32_t _id;
+};
+
+/**
+ * Allows printing the symbol `v` into the stream `s`.
+ */
+inline std::ostream& operator<<(std::ostream& s, const Symbol& v) {
+  return s << v.str();
+}
+
+/**
+ * Hash of a symbol, which is just its index.
+ */
+template<>
+struct std::hash<Symbol> {
+  std::size_t operator()(const Symbol& v) const noexcept {
+    return v.id();
+  }
+};
@@ -0,0 +1,157 @@
+#include "SymbolTable.hpp"
+
+/**
+ * Qualified name of an entity, from the names of its enclosing namespaces
+ * and types, up to any scope from which it or an enclosing entity was moved
+ * into a group.
+ *
+ * @ingroup developer
+ */
+static std::string qualify(const Entity& entity) {
+  std::string name = entity.name;
+  for (auto e = &entity; e; e = e->parent) {
+    if (e != &entity && (e->type == EntityType::NAMESPACE ||
+        e->type == EntityType::TYPE)) {
+      name.insert(0, "::");
+      name.insert(0, e->name.str());
+    }
+    if (!e->scope.empty()) {
+      /* moved into a group, whose parents are not its scopes */
+      name.insert(0, "::");
+      name.insert(0, e->scope);
+      break;
+    }
+  }
+  return name;
+}
+
+void SymbolTable::insert(const Entity& entity,
+    const std::filesystem::path& page, const std::string& anchor) {
+  std::string name = qualify(entity);
+  if (entity.type == EntityType::NAMESPACE ||
+      entity.type == EntityType::TYPE) {
+    scopes.try_emplace(&entity, name);
+  }
+
+  /* for overloads, the first inserted is kept */
+  targets.try_emplace(std::move(name), Target{&entity, entity.type, page,
+      anchor});
+}
+
+void SymbolTable::insert(const std::string& name, const Target& target) {
+  targets.try_emplace(name, target);
+}
+
+const SymbolTable::Target* SymbolTable::find(std::string_view name,
+    const Entity& from) const {
+  /* normalize, accepting Doxygen-style `Type#member` and `function()` */
+  std::string key(name);
+  for (auto pos = key.find('#'); pos != std::string::npos;
+      pos = key.find('#', pos)) {
+    key.replace(pos, 1, "::");
+  }
+  if (key.ends_with("()") && key.find("operator") == std::string::npos) {
+    key.resize(key.size() - 2);
+  }
+  if (key.starts_with("::")) {
+    /* explicitly global */
+    auto iter = targets.find(key.substr(2));
+    return iter == targets.end() ? nullptr : &iter->second;
+  }
+
+  /* search enclosing scopes from innermost outward */
+  std::string prefix = scope(from);
+  for (;;) {
+    auto iter = targets.find(prefix.empty() ? key : prefix + "::" + key);
+    if (iter != targets.end()) {
+      return &iter->second;
+    } else if (prefix.empty()) {
+      return nullptr;
+    } else {
+      auto pos = prefix.rfind("::");
+      prefix.resize(pos == std::string::npos ? 0 : pos);
+    }
+  }
+}
+
+void SymbolTable::clear() {
+  targets.clear();
+  scopes.clear();
+}
+
+std::string SymbolTable::marker(const Kind kind, const std::string_view& name,
+    const std::string_view& text) {
+  std::string r;
+  r.reserve(name.size() + text.size() + 4);
+  r.push_back(MARKER_BEGIN);
+  r.push_back(kind);
+  r.append(name);
+  r.push_back(MARKER_SEPARATOR);
+  r.append(text);
+  r.push_back(MARKER_END);
+  return r;
+}
+
+std::string SymbolTable::resolve(const std::string_view& str,
+    const Entity& from, const std::filesystem::path& dir) const {
+  std::string r;
+  std::size_t from_pos = 0;
+  auto begin = str.find(MARKER_BEGIN);
+  while (begin != std::string_view::npos) {
+    auto sep = str.find(MARKER_SEPARATOR, begin);
+    auto end = str.find(MARKER_END, begin);
+    if (sep == std::string_view::npos || end == std::string_view::npos ||
+        sep > end || sep < begin + 2) {
+      /* malformed, leave as is */
+      break;
+    }
+    r.append(str.substr(from_pos, begin - from_pos));
+
+    Kind kind = Kind(str[begin + 1]);
+    auto name = str.substr(begin + 2, sep - begin - 2);
+    auto text = str.substr(sep + 1, end - sep - 1);
+    auto target = find(name, from);
+    if (target) {
+      r.push_back('[');
+      r.append(text);
+      r.append("](");
+      r.append(link(*target, dir));
+      r.push_back(')');
+    } else if (kind == REF) {
+      r.push_back('[');
+      r.append(text);
+      r.append("](#");
+      r.append(name);
+      r.push_back(')');
+    } else {
+      r.append(text);
+    }
+
+    from_pos = end + 1;
+    begin = str.find(MARKER_BEGIN, from_pos);
+  }
+  r.append(str.substr(from_pos));
+  return r;
+}
+
+std::string SymbolTable::link(const Target& target,
+    const std::filesystem::path& dir) {
+  std::string r = target.page.lexically_relative(dir).generic_string();
+  if (!target.anchor.empty()) {
+    r.push_back('#');
+    r.append(target.anchor);
+  }
+  return r;
+}
+
+std::string SymbolTable::scope(const Entity& entity) const {
+  for (auto e = &entity; e; e = e->parent) {
+    if (e->type == EntityType::NAMESPACE || e->type == EntityType::TYPE) {
+      auto iter = scopes.find(e);
+      return (iter == scopes.end()) ? qualify(*e) : iter->second;
+    } else if (!e->scope.empty()) {
+      return e->scope;
+    }
+  }
+  return std::string();
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Entity.hpp"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * Table of documented entities by fully qualified name, for resolving
+ * cross-references.
+ *
+ * @ingroup developer
+ *
+ * The table is populated once, after parsing, with the page and anchor at
+ * which each entity is documented. Qualified names are formed from the
+ * names of enclosing namespaces and types, separated by `::`; groups do not
+ * contribute, as they are not C++ scopes, and an entity moved into a group
+ * with `@ingroup` is qualified by the scope from which it was moved. Overloads share a name, and so an
+ * entry, which is that of the first overload inserted.
+ *
+ * Names are resolved as in C++, from the innermost enclosing scope of the
+ * referring entity outward to global scope, with one hash lookup per
+ * enclosing scope.
+ *
+ * Cross-references in documentation (from `@ref` and `@see`) are recorded
+ * by Doc as markers, created with `marker()`, and replaced by links on
+ * output with `resolve()`.
+ */
+class SymbolTable {
+public:
+  /**
+   * Target of a cross-reference.
+   */
+  struct Target {
+    /**
+     * Entity, or `nullptr` for a target inserted by name, e.g. as recorded
+     * by an earlier build, whose entity is not in the model.
+     */
+    const Entity* entity;
+
+    /**
+     * Type of the entity.
+     */
+    EntityType type;
+
+    /**
+     * Page on which the entity is documented.
+     */
+    std::filesystem::path page;
+
+    /**
+     * Anchor on that page, or empty for the top of the page.
+     */
+    std::string anchor;
+  };
+
+  /**
+   * Kinds of cross-reference marker.
+   */
+  enum Kind : char {
+    /**
+     * From `@ref`. If unresolved, becomes a link to an anchor of the same
+     * name on the same page.
+     */
+    REF = 'r',
+
+    /**
+     * From `@see`. If unresolved, becomes plain text.
+     */
+    SEE = 's'
+  };
+
+  /**
+   * Insert an entity.
+   *
+   * @param entity Entity.
+   * @param page Page on which the entity is documented.
+   * @param anchor Anchor on that page, or empty for the top of the page.
+   */
+  void insert(const Entity& entity, const std::filesystem::path& page,
+      const std::string& anchor);
+
+  /**
+   * Insert a target by qualified name. If there is already a target of that
+   * name, it is kept instead.
+   *
+   * @param name Qualified name.
+   * @param target Target.
+   */
+  void insert(const std::string& name, const Target& target);
+
+  /**
+   * Targets, by qualified name.
+   */
+  const std::unordered_map<std::string,Target>& entries() const {
+    return targets;
+  }
+
+  /**
+   * Find an entity by name.
+   *
+   * @param name Name, optionally qualified.
+   * @param from Referring entity. Name lookup begins from its innermost
+   * enclosing scope.
+   *
+   * @return Target, or `nullptr` if not found.
+   */
+  const Target* find(std::string_view name, const Entity& from) const;
+
+  /**
+   * Clear the table.
+   */
+  void clear();
+
+  /**
+   * Create a cross-reference marker.
+   *
+   * @param kind Kind of marker.
+   * @param name Name to resolve.
+   * @param text Link text.
+   */
+  static std::string marker(const Kind kind, const std::string_view& name,
+      const std::string_view& text);
+
+  /**
+   * Replace cross-reference markers with Markdown links.
+   *
+   * @param str String containing markers.
+   * @param from Referring entity.
+   * @param dir Directory of the page on which the string will appear. Links
+   * are relative to this.
+   *
+   * @return String with markers replaced.
+   */
+  std::string resolve(const std::string_view& str, const Entity& from,
+      const std::filesystem::path& dir) const;
+
+  /**
+   * Produce a relative link to a target.
+   *
+   * @param target Target.
+   * @param dir Directory of the page on which the link will appear.
+   */
+  static std::string link(const Target& target,
+      const std::filesystem::path& dir);
+
+  /**
+   * Delimiters of cross-reference markers. These are control characters,
+   * which do not otherwise occur in documentation comments.
+   */
+  static constexpr char MARKER_BEGIN = '\x02';
+  static constexpr char MARKER_SEPARATOR = '\x1f';
+  static constexpr char MARKER_END = '\x03';
+
+private:
+  /**
+   * Qualified name of the innermost enclosing scope of an entity, being the
+   * entity itself if it is a namespace or type, or the scope from which it
+   * was moved into a group (see Entity::scope). Empty for global scope.
+   */
+  std::string scope(const Entity& entity) const;
+
+  /**
+   * Targets, by qualified name.
+   */
+  std::unordered_map<std::string,Target> targets;
+
+  /**
+   * Qualified names of scopes, by entity.
+   */
+  std::unordered_map<const Entity*,std::string> scopes;
+};
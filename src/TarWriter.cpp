@@ -0,0 +1,135 @@
+#include "TarWriter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Size of a block of a tar archive.
+ *
+ * @ingroup developer
+ */
+static constexpr std::size_t block_size = 512;
+
+/**
+ * Write a number to a header field, in octal, zero-padded, and terminated
+ * with a null character.
+ *
+ * @ingroup developer
+ */
+static void octal(char* field, const std::size_t width,
+    unsigned long long value) {
+  field[width - 1] = '\0';
+  for (std::size_t i = width - 1; i > 0; --i) {
+    field[i - 1] = '0' + (value & 7);
+    value >>= 3;
+  }
+}
+
+/**
+ * Split a file name into the prefix and name fields of a ustar header, at a
+ * slash, if it is too long for the name field alone.
+ *
+ * @ingroup developer
+ *
+ * @return True if the file name fits, false if it requires an extended
+ * header.
+ */
+static bool split(const std::string_view& path, std::string_view& prefix,
+    std::string_view& name) {
+  if (path.size() <= 100) {
+    prefix = std::string_view();
+    name = path;
+    return true;
+  }
+  std::size_t slash = path.find('/', path.size() - 101);
+  if (slash == std::string_view::npos || slash > 155 || slash == 0) {
+    return false;
+  }
+  prefix = path.substr(0, slash);
+  name = path.substr(slash + 1);
+  return true;
+}
+
+TarWriter::TarWriter(const std::filesystem::path& file) :
+    file(file),
+    stream(file, std::ios::binary | std::ios::trunc),
+    out(stream),
+    mtime(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()) {
+  if (!stream.is_open()) {
+    throw std::runtime_error("could not write " + file.string());
+  }
+}
+
+void TarWriter::add(const std::string_view& name,
+    const std::string_view& contents) {
+  std::string_view prefix, base;
+  if (!split(name, prefix, base)) {
+    /* pax extended header with the full name; the length of each record
+     * includes the digits of the length itself */
+    std::string record = " path=" + std::string(name) + "\n";
+    std::size_t length = record.size();
+    while (std::to_string(length).size() + record.size() != length) {
+      length = std::to_string(length).size() + record.size();
+    }
+    record = std::to_string(length) + record;
+    header("PaxHeader", record.size(), 'x');
+    data(record);
+  }
+  header(name, contents.size(), '0');
+  data(contents);
+}
+
+void TarWriter::close() {
+  /* end of archive is two blocks of zeros */
+  char zeros[2*block_size] = {};
+  out.write(std::string_view(zeros, sizeof(zeros)));
+  out.flush();
+  stream.close();
+  if (!stream) {
+    throw std::runtime_error("could not write " + file.string());
+  }
+}
+
+void TarWriter::header(const std::string_view& path, const std::size_t size,
+    const char type) {
+  std::string_view prefix, name;
+  if (!split(path, prefix, name)) {
+    /* truncated, for readers that do not support extended headers */
+    name = path.substr(path.size() - 100);
+  }
+
+  char block[block_size] = {};
+  std::copy(name.begin(), name.end(), block);
+  octal(block + 100, 8, 0644);  // mode
+  octal(block + 108, 8, 0);  // uid
+  octal(block + 116, 8, 0);  // gid
+  octal(block + 124, 12, size);
+  octal(block + 136, 12, mtime);
+  block[156] = type;
+  std::memcpy(block + 257, "ustar", 6);  // magic, with null terminator
+  std::memcpy(block + 263, "00", 2);  // version
+  std::copy(prefix.begin(), prefix.end(), block + 345);
+
+  /* checksum is of the header with the checksum field as spaces, written
+   * as six octal digits, a null character, and a space */
+  std::memset(block + 148, ' ', 8);
+  unsigned sum = 0;
+  for (char c : block) {
+    sum += static_cast<unsigned char>(c);
+  }
+  octal(block + 148, 7, sum);
+  out.write(std::string_view(block, sizeof(block)));
+}
+
+void TarWriter::data(const std::string_view& contents) {
+  out.write(contents);
+  std::size_t rem = contents.size() % block_size;
+  if (rem > 0) {
+    char zeros[block_size] = {};
+    out.write(std::string_view(zeros, block_size - rem));
+  }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "BufferedWriter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+/**
+ * Writer of a tar archive, in POSIX ustar format, with pax extended headers
+ * for long file names.
+ *
+ * @ingroup developer
+ *
+ * Files are appended in sequence, so that the archive is written in one
+ * pass, through a buffer, with no seeking. Only regular files are written;
+ * directories are created implicitly on extraction.
+ */
+class TarWriter {
+public:
+  /**
+   * Constructor. Creates or truncates the archive.
+   *
+   * @param file File name of the archive.
+   */
+  TarWriter(const std::filesystem::path& file);
+
+  TarWriter(const TarWriter&) = delete;
+  TarWriter& operator=(const TarWriter&) = delete;
+
+  /**
+   * Append a file.
+   *
+   * @param name File name within the archive, with forward slashes as
+   * separators.
+   * @param contents Contents.
+   */
+  void add(const std::string_view& name, const std::string_view& contents);
+
+  /**
+   * Finish the archive, writing the end-of-archive marker and flushing all
+   * output. No further files may be appended.
+   */
+  void close();
+
+private:
+  /**
+   * Write a header block.
+   *
+   * @param path File name. If too long for the header, it is truncated, and
+   * should be given in full by a preceding extended header.
+   * @param size Size of the data that follows.
+   * @param type Type flag: '0' for a regular file, 'x' for an extended
+   * header.
+   */
+  void header(const std::string_view& path, const std::size_t size,
+      const char type);
+
+  /**
+   * Write data, padded with zeros to a whole number of blocks.
+   */
+  void data(const std::string_view& contents);
+
+  /**
+   * File name of the archive.
+   */
+  std::filesystem::path file;
+
+  /**
+   * Output stream.
+   */
+  std::ofstream stream;
+
+  /**
+   * Buffered writer to the output stream.
+   */
+  BufferedWriter out;
+
+  /**
+   * Modification time recorded for all files, in seconds since the epoch.
+   */
+  long long mtime;
+};
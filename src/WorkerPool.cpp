@@ -0,0 +1,52 @@
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+WorkerPool::WorkerPool(const unsigned nthreads) :
+    nthreads(nthreads > 0 ? nthreads :
+        std::max(1u, std::thread::hardware_concurrency())) {
+  //
+}
+
+void WorkerPool::run(const std::size_t n,
+    const std::function<void(std::size_t)>& f) {
+  std::atomic<std::size_t> next = 0;
+  std::atomic<bool> failed = false;
+  std::mutex mutex;
+  std::size_t first_error = n;
+  std::exception_ptr error;
+
+  auto work = [&]() {
+    for (std::size_t i = next++; i < n && !failed; i = next++) {
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard lock(mutex);
+        if (i < first_error) {
+          first_error = i;
+          error = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+
+  /* the calling thread is one of the workers */
+  std::size_t nworkers = std::min<std::size_t>(nthreads, n);
+  std::vector<std::thread> threads;
+  for (std::size_t k = 1; k < nworkers; ++k) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
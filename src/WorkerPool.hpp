@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Pool of worker threads for running independent tasks concurrently.
+ *
+ * @ingroup developer
+ *
+ * Tasks are identified by index. Workers claim the next unclaimed index in
+ * turn, so that tasks are started in order, but may finish in any order;
+ * results should be stored by index and merged afterward, for output that
+ * does not depend on scheduling.
+ */
+class WorkerPool {
+public:
+  /**
+   * Constructor.
+   *
+   * @param nthreads Number of threads. If zero, uses the number of hardware
+   * threads.
+   */
+  WorkerPool(const unsigned nthreads = 0);
+
+  /**
+   * Run tasks, returning once all have completed.
+   *
+   * @param n Number of tasks.
+   * @param f Task function, called once for each index in `[0, n)`.
+   *
+   * If tasks throw exceptions, the remaining tasks are abandoned, and the
+   * exception of the task with the lowest index is rethrown.
+   */
+  void run(const std::size_t n, const std::function<void(std::size_t)>& f);
+
+  /**
+   * Number of threads.
+   */
+  unsigned size() const {
+    return nthreads;
+  }
+
+private:
+  /**
+   * Number of threads.
+   */
+  unsigned nthreads;
+};
@@ -0,0 +1,107 @@
+#include "WriteQueue.hpp"
+
+#include <algorithm>
+
+/**
+ * Maximum number of writes taken from the queue at once by a writer thread.
+ *
+ * @ingroup developer
+ */
+static constexpr std::size_t batch_size = 16;
+
+WriteQueue::WriteQueue(const unsigned nthreads, const std::size_t capacity) :
+    capacity(capacity),
+    pending(0),
+    stopping(false) {
+  unsigned n = nthreads > 0 ? nthreads :
+      std::max(2u, std::thread::hardware_concurrency());
+  if (this->capacity == 0) {
+    this->capacity = 64*std::size_t(n);
+  }
+  for (unsigned k = 0; k < n; ++k) {
+    threads.emplace_back(&WriteQueue::work, this);
+  }
+}
+
+WriteQueue::~WriteQueue() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  pushed.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void WriteQueue::push(std::function<void()>&& f) {
+  bool full;
+  {
+    std::unique_lock lock(mutex);
+    taken.wait(lock, [this]() { return writes.size() < capacity; });
+    writes.push_back(std::move(f));
+    ++pending;
+    full = writes.size() >= batch_size;
+  }
+  if (full) {
+    /* writer threads are woken for whole batches only, rather than for
+     * every write, to reduce context switches */
+    pushed.notify_one();
+  }
+}
+
+void WriteQueue::wait() {
+  /* wake writer threads for any partial batch */
+  pushed.notify_all();
+  std::unique_lock lock(mutex);
+  done.wait(lock, [this]() { return pending == 0; });
+  if (error) {
+    std::exception_ptr e = error;
+    error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+void WriteQueue::work() {
+  std::vector<std::function<void()>> batch;
+  batch.reserve(batch_size);
+  for (;;) {
+    {
+      std::unique_lock lock(mutex);
+      pushed.wait(lock, [this]() { return !writes.empty() || stopping; });
+      if (writes.empty()) {
+        return;  // stopping, and nothing left to write
+      }
+      std::size_t n = std::min(batch_size, writes.size());
+      std::move(writes.begin(), writes.begin() + n, std::back_inserter(batch));
+      writes.erase(writes.begin(), writes.begin() + n);
+    }
+    taken.notify_all();
+
+    /* once a write has failed, the rest are abandoned */
+    std::exception_ptr e;
+    for (auto& f : batch) {
+      if (!e) {
+        try {
+          f();
+        } catch (...) {
+          e = std::current_exception();
+        }
+      }
+    }
+
+    bool finished;
+    {
+      std::lock_guard lock(mutex);
+      if (e && !error) {
+        error = e;
+      }
+      pending -= batch.size();
+      finished = pending == 0;
+    }
+    batch.clear();
+    if (finished) {
+      done.notify_all();
+    }
+  }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Queue of writes, run asynchronously by dedicated threads.
+ *
+ * @ingroup developer
+ *
+ * Writes are pushed by the threads that produce them, such as those
+ * rendering pages, which can then continue while the writes are carried out
+ * in the background, rather than stalling on I/O. The writer threads take
+ * writes from the queue in batches, to reduce contention on the queue when
+ * writes are small. The queue has a limited capacity, beyond which pushes
+ * block, so that memory use for pending writes is bounded.
+ */
+class WriteQueue {
+public:
+  /**
+   * Constructor. Starts the writer threads.
+   *
+   * @param nthreads Number of writer threads. If zero, uses the number of
+   * hardware threads, but at least two.
+   * @param capacity Maximum number of pending writes. If zero, uses 64 per
+   * writer thread.
+   */
+  WriteQueue(const unsigned nthreads = 0, const std::size_t capacity = 0);
+
+  /**
+   * Destructor. Completes any pending writes, then stops the writer
+   * threads.
+   */
+  ~WriteQueue();
+
+  WriteQueue(const WriteQueue&) = delete;
+  WriteQueue& operator=(const WriteQueue&) = delete;
+
+  /**
+   * Push a write, blocking while the queue is full.
+   *
+   * @param f Write function.
+   */
+  void push(std::function<void()>&& f);
+
+  /**
+   * Wait until all writes pushed so far have completed. If writes threw
+   * exceptions, the first is rethrown.
+   */
+  void wait();
+
+private:
+  /**
+   * Loop of a writer thread.
+   */
+  void work();
+
+  /**
+   * Pending writes not yet taken by a writer thread.
+   */
+  std::deque<std::function<void()>> writes;
+
+  /**
+   * Writer threads.
+   */
+  std::vector<std::thread> threads;
+
+  /**
+   * Mutex for the queue.
+   */
+  std::mutex mutex;
+
+  /**
+   * Signaled when a batch of writes is ready, on waiting, or on stopping.
+   */
+  std::condition_variable pushed;
+
+  /**
+   * Signaled when writes are taken from the queue.
+   */
+  std::condition_variable taken;
+
+  /**
+   * Signaled when all writes have completed.
+   */
+  std::condition_variable done;
+
+  /**
+   * Exception of the first write that failed, if any.
+   */
+  std::exception_ptr error;
+
+  /**
+   * Maximum number of pending writes.
+   */
+  std::size_t capacity;
+
+  /**
+   * Number of writes pushed but not yet completed.
+   */
+  std::size_t pending;
+
+  /**
+   * Are the writer threads to stop once the queue is empty?
+   */
+  bool stopping;
+};
@@ -72,17 +72,36 @@ int main(int argc, char** argv) {
       "Output directory.");
   app.add_option("--coverage", driver.coverage,
       "Code coverage file (.gcov or .json).");
+  app.add_option("--search", driver.search,
+      "Search: mkdocs plugin, or doxide index.")->
+      check(CLI::IsMember({"mkdocs", "doxide"}));
+  app.add_option("--archive", driver.archive,
+      "For build and watch, write a tar archive of the output instead of the output directory.");
+  app.add_option("--snapshot", driver.snapshot,
+      "Load the parsed model from a snapshot file written by build, instead of parsing.");
+  app.add_option("--save-snapshot", driver.save_snapshot,
+      "For build, save the parsed model to a snapshot file.");
   app.set_version_flag("--version,-v", PACKAGE_VERSION, "Doxide version.");
   app.add_subcommand("init",
       "Initialize configuration files.")->
       fallthrough()->
       callback([&]() { driver.init(); });
-  app.add_subcommand("build",
-      "Build documentation in output directory.")->
+  auto build_cmd = app.add_subcommand("build",
+      "Build documentation in output directory.");
+  build_cmd->add_option("--format", driver.output_format,
+      "Output format: markdown for MkDocs, or html.")->
+      check(CLI::IsMember({"markdown", "html"}));
+  build_cmd->add_option("--only", driver.only,
+      "Build only the pages of one namespace, group or type, by qualified name, group name or page path.");
+  build_cmd->
       fallthrough()->
       callback([&]() { driver.build(); });
-  app.add_subcommand("watch",
-      "Watch the documentation's source files and rebuild it on changes.")->
+  auto watch_cmd = app.add_subcommand("watch",
+      "Watch the documentation's source files and rebuild it on changes.");
+  watch_cmd->add_option("--format", driver.output_format,
+      "Output format: markdown for MkDocs, or html.")->
+      check(CLI::IsMember({"markdown", "html"}));
+  watch_cmd->
       fallthrough()->
       callback([&]() { driver.watch(); });
   app.add_subcommand("clean",
@@ -93,6 +112,16 @@ int main(int argc, char** argv) {
       "Output code coverage data to stdout in JSON format.")->
       fallthrough()->
       callback([&]() { driver.cover(); });
+  auto export_cmd = app.add_subcommand("export",
+      "Export the entity model to a file or stdout.");
+  export_cmd->add_option("--format", driver.format,
+      "Export format.")->
+      check(CLI::IsMember({"json"}));
+  export_cmd->add_option("--file", driver.export_file,
+      "Export file (default stdout).");
+  export_cmd->
+      fallthrough()->
+      callback([&]() { driver.exportModel(); });
   app.require_subcommand(1);
   CLI11_PARSE(app, argc, argv);
 }